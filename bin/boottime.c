@@ -0,0 +1,10 @@
+// bin/boottime.c
+#include "commands.h"
+#include "../kernel/boottime.h"
+
+void cmd_boottime(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    
+    boottime_report();
+}
@@ -5,6 +5,19 @@
 #include "../shell/shell.h"
 
 void cmd_cat(int argc, char** argv) {
+    stream_t* in = shell_stdin();
+    
+    // Sin fichero copia la entrada redirigida por trozos
+    if (argc < 2 && in) {
+        char chunk[256];
+        int count;
+        while ((count = stream_read(in, chunk, sizeof(chunk) - 1)) > 0) {
+            chunk[count] = '\0';
+            screen_print(chunk);
+        }
+        return;
+    }
+    
     if (argc < 2) {
         screen_print("Usage: cat <filename>\n");
         return;
@@ -36,8 +49,11 @@ void cmd_cat(int argc, char** argv) {
         return;
     }
 
-    for (int i = 0; i < size; i++) {
-        screen_print_char(buffer[i]);
+    // Por trozos: un solo movimiento del cursor por bloque y el cerrojo de pantalla no se
+    // retiene durante todo el fichero
+    for (int i = 0; i < size; i += 256) {
+        int count = size - i < 256 ? size - i : 256;
+        screen_write((const char*)buffer + i, count);
     }
     if (size > 0 && buffer[size - 1] != '\n') {
         screen_print("\n");
@@ -17,6 +17,14 @@ void cmd_whoami(int argc, char** argv);
 void cmd_shutdown(int argc, char** argv);
 void cmd_reboot(int argc, char** argv);
 void cmd_ping(int argc, char** argv);
+void cmd_netstat(int argc, char** argv);
+void cmd_smp(int argc, char** argv);
+void cmd_lockstat(int argc, char** argv);
+void cmd_mem(int argc, char** argv);
+void cmd_boottime(int argc, char** argv);
+void cmd_grep(int argc, char** argv);
+void cmd_head(int argc, char** argv);
+void cmd_membench(int argc, char** argv);
 
 char* shell_get_current_dir(void);
 char* shell_get_username(void);
@@ -3,6 +3,7 @@
 #include "../drivers/screen.h"
 #include "../drivers/rtc.h"
 #include "../kernel/kernel.h"
+#include "../kernel/kprintf.h"
 
 static const char* weekday_names[] = {
     "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"
@@ -13,31 +14,6 @@ static const char* month_names[] = {
     "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
 };
 
-static void int_to_str(int num, char* str, int min_width) {
-    char temp[16];
-    int i = 0;
-    
-    if (num == 0) {
-        temp[i++] = '0';
-    } else {
-        while (num > 0) {
-            temp[i++] = '0' + (num % 10);
-            num /= 10;
-        }
-    }
-    
-    int j = 0;
-    while (i < min_width) {
-        str[j++] = ' ';
-        min_width--;
-    }
-    
-    while (i > 0) {
-        str[j++] = temp[--i];
-    }
-    str[j] = '\0';
-}
-
 void cmd_date(int argc, char** argv) {
     (void)argc;
     (void)argv;
@@ -45,60 +21,11 @@ void cmd_date(int argc, char** argv) {
     rtc_time_t time;
     rtc_get_time(&time);
     
-    char buffer[128];
-    char num_str[16];
-    
-    buffer[0] = '\0';
-    
-    // Weekday
-    if (time.weekday >= 1 && time.weekday <= 7) {
-        strcat(buffer, weekday_names[time.weekday - 1]);
-    } else {
-        strcat(buffer, weekday_names[0]);
-    }
-    strcat(buffer, " ");
-    
-    // Month
-    if (time.month >= 1 && time.month <= 12) {
-        strcat(buffer, month_names[time.month - 1]);
-    } else {
-        strcat(buffer, month_names[0]);
-    }
-    strcat(buffer, " ");
-    
-    // Day
-    int_to_str(time.day, num_str, 2);
-    strcat(buffer, num_str);
-    strcat(buffer, " ");
-    
-    // Hour
-    int_to_str(time.hour, num_str, 2);
-    if (strlen(num_str) == 1) {
-        strcat(buffer, "0");
-    }
-    strcat(buffer, num_str);
-    strcat(buffer, ":");
-    
-    // Minute
-    int_to_str(time.minute, num_str, 2);
-    if (strlen(num_str) == 1) {
-        strcat(buffer, "0");
-    }
-    strcat(buffer, num_str);
-    strcat(buffer, ":");
-    
-    // Second
-    int_to_str(time.second, num_str, 2);
-    if (strlen(num_str) == 1) {
-        strcat(buffer, "0");
-    }
-    strcat(buffer, num_str);
-    strcat(buffer, " UTC ");
-    
-    // Year
-    int_to_str(time.year, num_str, 4);
-    strcat(buffer, num_str);
-    strcat(buffer, "\n");
+    const char* weekday = time.weekday >= 1 && time.weekday <= 7 ?
+                          weekday_names[time.weekday - 1] : weekday_names[0];
+    const char* month = time.month >= 1 && time.month <= 12 ?
+                        month_names[time.month - 1] : month_names[0];
     
-    screen_print(buffer);
+    kprintf("%s %s %2u %02u:%02u:%02u UTC %4u\n", weekday, month,
+            time.day, time.hour, time.minute, time.second, time.year);
 }
\ No newline at end of file
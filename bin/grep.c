@@ -0,0 +1,64 @@
+// bin/grep.c
+#include "commands.h"
+#include "../drivers/screen.h"
+#include "../kernel/kernel.h"
+#include "../shell/shell.h"
+
+static int contains(const char* line, const char* pattern) {
+    int length = strlen(pattern);
+    for (; *line; line++) {
+        if (strncmp(line, pattern, length) == 0) {
+            return 1;
+        }
+    }
+    return length == 0;
+}
+
+void cmd_grep(int argc, char** argv) {
+    int invert = 0;
+    int arg = 1;
+    
+    if (arg < argc && strcmp(argv[arg], "-v") == 0) {
+        invert = 1;
+        arg++;
+    }
+    
+    if (arg >= argc || (arg + 1 >= argc && !shell_stdin())) {
+        screen_print("Usage: grep [-v] <pattern> [file]\n");
+        return;
+    }
+    
+    const char* pattern = argv[arg];
+    stream_t* in = shell_stdin();
+    stream_t* file = 0;
+    
+    if (arg + 1 < argc) {
+        char path[256];
+        shell_resolve_path(argv[arg + 1], path);
+        file = stream_open_file(path, STREAM_READ);
+        if (!file) {
+            screen_print("grep: ");
+            screen_print(argv[arg + 1]);
+            screen_print(": No such file or directory\n");
+            return;
+        }
+        in = file;
+    }
+    
+    // Línea a línea: la memoria no depende del tamaño de la entrada.
+    // Una línea más larga que el búfer sigue la suerte de su primer trozo
+    char line[256];
+    int printing = 0;
+    int count;
+    while ((count = stream_read_line(in, line, sizeof(line))) > 0) {
+        if (printing || contains(line, pattern) != invert) {
+            screen_print(line);
+            printing = 1;
+        }
+        if (line[count - 1] == '\n') {
+            printing = 0;
+        }
+    }
+    
+    stream_close_reader(file);
+}
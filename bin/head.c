@@ -0,0 +1,53 @@
+// bin/head.c
+#include "commands.h"
+#include "../drivers/screen.h"
+#include "../kernel/kernel.h"
+#include "../shell/shell.h"
+
+#define HEAD_DEFAULT_LINES 10
+
+void cmd_head(int argc, char** argv) {
+    int lines = HEAD_DEFAULT_LINES;
+    int arg = 1;
+    
+    if (arg + 1 < argc && strcmp(argv[arg], "-n") == 0) {
+        lines = 0;
+        for (const char* p = argv[arg + 1]; *p >= '0' && *p <= '9'; p++) {
+            lines = lines * 10 + (*p - '0');
+        }
+        arg += 2;
+    }
+    
+    if (arg >= argc && !shell_stdin()) {
+        screen_print("Usage: head [-n lines] [file]\n");
+        return;
+    }
+    
+    stream_t* in = shell_stdin();
+    stream_t* file = 0;
+    
+    if (arg < argc) {
+        char path[256];
+        shell_resolve_path(argv[arg], path);
+        file = stream_open_file(path, STREAM_READ);
+        if (!file) {
+            screen_print("head: ");
+            screen_print(argv[arg]);
+            screen_print(": No such file or directory\n");
+            return;
+        }
+        in = file;
+    }
+    
+    // Al terminar antes del final el escritor de la tubería deja de bloquearse
+    char line[256];
+    int count;
+    while (lines > 0 && (count = stream_read_line(in, line, sizeof(line))) > 0) {
+        screen_print(line);
+        if (line[count - 1] == '\n') {
+            lines--;
+        }
+    }
+    
+    stream_close_reader(file);
+}
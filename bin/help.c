@@ -11,8 +11,8 @@ void cmd_help(int argc, char** argv) {
     screen_print("ls        - List files and directories\n");
     screen_print("cd        - Change directory\n");
     screen_print("mkdir     - Create directory\n");
-    screen_print("cat       - Display file contents\n");
-    screen_print("echo      - Print text or create file\n");
+    screen_print("cat       - Display file contents or standard input\n");
+    screen_print("echo      - Print text\n");
     screen_print("touch     - Create empty file\n");
     screen_print("rm        - Remove file\n");
     screen_print("pwd       - Print working directory\n");
@@ -22,4 +22,17 @@ void cmd_help(int argc, char** argv) {
     screen_print("shutdown  - Power off the system\n");
     screen_print("reboot    - Restart the system\n\n");
     screen_print("ping      - Test network connectivity\n");
+    screen_print("netstat   - Show per-protocol network counters\n");
+    screen_print("smp       - Show processors and scheduler statistics\n");
+    screen_print("lockstat  - Show lock contention counters (LOCK_STATS builds)\n");
+    screen_print("mem       - Show the physical memory map\n");
+    screen_print("boottime  - Show time spent in each boot stage\n");
+    screen_print("grep      - Print lines containing a pattern\n");
+    screen_print("head      - Print the first lines of a file or input\n");
+    screen_print("membench  - Measure string and memory routines in bytes per cycle\n");
+    screen_print("jobs      - List background jobs\n");
+    screen_print("fg        - Show a background job's output and wait for it\n");
+    screen_print("wait      - Wait for background jobs\n");
+    screen_print("\nCommands can be joined with | and redirected with <, > and >>\n");
+    screen_print("A trailing & runs the line in the background\n");
 }
\ No newline at end of file
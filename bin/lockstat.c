@@ -0,0 +1,29 @@
+// bin/lockstat.c
+#include "commands.h"
+#include "../drivers/screen.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/kernel.h"
+#include "../kernel/kprintf.h"
+
+void cmd_lockstat(int argc, char** argv) {
+    if (!spinlock_stats_enabled()) {
+        screen_print("Lock statistics not compiled in (build with make LOCK_STATS=1)\n");
+        return;
+    }
+    
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        spinlock_stats_reset();
+        screen_print("Lock statistics cleared\n");
+        return;
+    }
+    
+    screen_print("\nLock          Acquired  Contended      Spins  Max spins\n");
+    
+    for (const spinlock_t* lock = spinlock_stats_next(0); lock; lock = spinlock_stats_next(lock)) {
+        lock_stats_t stats;
+        spinlock_get_stats(lock, &stats);
+        
+        kprintf("%-12s%10u%11u%11u%11u\n", lock->name ? lock->name : "?",
+                stats.acquisitions, stats.contended, stats.spins, stats.max_spins);
+    }
+}
@@ -0,0 +1,36 @@
+// bin/mem.c
+#include "commands.h"
+#include "../drivers/screen.h"
+#include "../kernel/memmap.h"
+#include "../kernel/memory.h"
+#include "../kernel/kernel.h"
+#include "../kernel/kprintf.h"
+
+static const char* region_type_name(uint32_t type) {
+    switch (type) {
+        case E820_USABLE:       return "usable";
+        case E820_RESERVED:     return "reserved";
+        case E820_ACPI_RECLAIM: return "ACPI data";
+        case E820_ACPI_NVS:     return "ACPI NVS";
+        case E820_BAD:          return "bad";
+        default:                return "unknown";
+    }
+}
+
+void cmd_mem(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    
+    screen_print(memmap_from_bios() ? "\nMemory map (E820):\n" : "\nMemory map (CMOS estimate):\n");
+    screen_print("Base        End            Size KB  Type\n");
+    
+    for (int i = 0; i < memmap_count(); i++) {
+        const memmap_region_t* r = memmap_get(i);
+        kprintf("0x%08X  0x%08X %11u  %s\n", r->base, r->base + r->length - 1,
+                r->length / 1024, region_type_name(r->type));
+    }
+    
+    kprintf("\nUsable: %u KB\n", memmap_total_usable() / 1024);
+    kprintf("Kernel pages: %u KB used of %u KB at 0x%08X\n", kmem_used() / 1024,
+            (kmem_limit() - kmem_base()) / 1024, kmem_base());
+}
@@ -0,0 +1,125 @@
+// bin/membench.c
+#include "commands.h"
+#include "../drivers/screen.h"
+#include "../kernel/cpu.h"
+#include "../kernel/memory.h"
+#include "../kernel/thread.h"
+#include "../kernel/kernel.h"
+#include "../kernel/kprintf.h"
+
+#define BENCH_MAX_SIZE  65536
+#define BENCH_BYTES     262144      // bytes procesados por medida
+#define BENCH_RUNS      4
+
+#define OP_MEMCPY  0
+#define OP_MEMMOVE 1
+#define OP_MEMSET  2
+#define OP_MEMCMP  3
+#define OP_STRLEN  4
+#define OP_STRCMP  5
+
+static uint8_t* buffer_a = 0;
+static uint8_t* buffer_b = 0;
+
+static const uint32_t sizes[] = { 64, 4096, BENCH_MAX_SIZE };
+
+// Centésimas de byte por ciclo con dos decimales
+static void run_op(int op, uint32_t size) {
+    volatile int sink;
+    
+    switch (op) {
+        case OP_MEMCPY:  memcpy(buffer_a, buffer_b, size); break;
+        case OP_MEMMOVE: memmove(buffer_a + 8, buffer_a, size); break;
+        case OP_MEMSET:  memset(buffer_a, 0x5A, size); break;
+        case OP_MEMCMP:  sink = memcmp(buffer_a, buffer_b, size); break;
+        case OP_STRLEN:  sink = strlen((const char*)buffer_a); break;
+        case OP_STRCMP:  sink = strcmp((const char*)buffer_a, (const char*)buffer_b); break;
+    }
+    (void)sink;
+}
+
+static void prepare(int op, uint32_t size) {
+    // Cadenas y bloques iguales: memcmp y strcmp recorren el tamaño entero
+    memset(buffer_a, 'a', BENCH_MAX_SIZE + 16);
+    memset(buffer_b, 'a', BENCH_MAX_SIZE + 16);
+    if (op == OP_STRLEN || op == OP_STRCMP) {
+        buffer_a[size - 1] = '\0';
+        buffer_b[size - 1] = '\0';
+    }
+}
+
+// Mejor de varias pasadas, sin expulsión durante la medida
+static uint32_t measure(int op, uint32_t size) {
+    uint32_t iterations = BENCH_BYTES / size;
+    uint32_t best = 0xFFFFFFFF;
+    
+    prepare(op, size);
+    
+    for (int run = 0; run < BENCH_RUNS; run++) {
+        preempt_disable();
+        uint32_t start = (uint32_t)cpu_read_tsc();
+        for (uint32_t i = 0; i < iterations; i++) {
+            run_op(op, size);
+        }
+        uint32_t cycles = (uint32_t)cpu_read_tsc() - start;
+        preempt_enable();
+        
+        if (cycles < best) {
+            best = cycles;
+        }
+    }
+    
+    if (best == 0) {
+        best = 1;
+    }
+    // iterations * size <= BENCH_BYTES, así que basta la aritmética de 32 bits
+    return iterations * size * 100 / best;
+}
+
+static void bench_row(const char* name, int op) {
+    char line[80];
+    int length = ksnprintf(line, sizeof(line), "%s", name);
+    
+    // Centésimas de byte por ciclo con dos decimales
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+        uint32_t rate = measure(op, sizes[i]);
+        length += ksnprintf(line + length, sizeof(line) - length, "%6u.%02u", rate / 100, rate % 100);
+    }
+    kprintf("%s\n", line);
+}
+
+void cmd_membench(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    
+    if (!cpu_has_feature(CPUID_EDX_TSC)) {
+        screen_print("membench: no TSC on this CPU\n");
+        return;
+    }
+    
+    if (!buffer_a) {
+        buffer_a = kmem_alloc(BENCH_MAX_SIZE + 16);
+        buffer_b = kmem_alloc(BENCH_MAX_SIZE + 16);
+        if (!buffer_a || !buffer_b) {
+            buffer_a = 0;
+            screen_print("membench: out of memory\n");
+            return;
+        }
+    }
+    
+    screen_print("Bytes per cycle       64 B     4 KB    64 KB\n");
+    bench_row("memcpy         ", OP_MEMCPY);
+    bench_row("memmove (back) ", OP_MEMMOVE);
+    bench_row("memset         ", OP_MEMSET);
+    bench_row("memcmp         ", OP_MEMCMP);
+    bench_row("strlen         ", OP_STRLEN);
+    bench_row("strcmp         ", OP_STRCMP);
+    
+    // La misma máquina sin los bloques XMM, para ver lo que aportan
+    if (string_sse2_enabled()) {
+        string_set_sse2(0);
+        bench_row("memcpy (rep)   ", OP_MEMCPY);
+        bench_row("memset (rep)   ", OP_MEMSET);
+        string_set_sse2(1);
+    }
+}
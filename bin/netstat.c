@@ -0,0 +1,67 @@
+// bin/netstat.c
+#include "commands.h"
+#include "../drivers/screen.h"
+#include "../drivers/network.h"
+#include "../net/ethernet.h"
+#include "../net/ip.h"
+#include "../kernel/kernel.h"
+#include "../kernel/kprintf.h"
+
+static void print_counters(const char* name, uint32_t rx_packets, uint32_t rx_bytes,
+                           uint32_t tx_packets, uint32_t tx_bytes) {
+    kprintf("  %-13s%10u%11u%10u%11u\n", name, rx_packets, rx_bytes, tx_packets, tx_bytes);
+}
+
+void cmd_netstat(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    
+    screen_print("Interface          RX pkts   RX bytes   TX pkts   TX bytes  Drops  Errs\n");
+    for (int i = 0; i < netdev_count(); i++) {
+        netdev_t* dev = netdev_get(i);
+        netdev_stats_t stats;
+        netdev_get_stats(dev, &stats);
+        
+        kprintf("  %-6s%-7s%10u%11u%10u%11u%7u%6u\n", dev->name, dev->driver,
+                stats.rx_packets, stats.rx_bytes, stats.tx_packets, stats.tx_bytes,
+                stats.rx_dropped, stats.tx_errors);
+    }
+    screen_print("\n");
+    
+    screen_print("Link layer         RX pkts   RX bytes   TX pkts   TX bytes\n");
+    for (int i = 0; i < ETH_PROTO_TABLE_SIZE; i++) {
+        const eth_protocol_t* proto = eth_get_protocol(i);
+        if (!proto) continue;
+        
+        char name[8];
+        if (proto->type == ETH_TYPE_ARP) {
+            strcpy(name, "ARP");
+        } else if (proto->type == ETH_TYPE_IP) {
+            strcpy(name, "IPv4");
+        } else {
+            ksnprintf(name, sizeof(name), "0x%04X", proto->type);
+        }
+        
+        print_counters(name, proto->rx_packets, proto->rx_bytes, proto->tx_packets, proto->tx_bytes);
+    }
+    kprintf("  unhandled    %10u\n\n", eth_get_unhandled_frames());
+    
+    screen_print("IP protocol        RX pkts   RX bytes   TX pkts   TX bytes\n");
+    for (int i = 0; i < 256; i++) {
+        const ip_protocol_t* proto = ip_get_protocol(i);
+        if (!proto) continue;
+        
+        char name[8];
+        if (i == IP_PROTO_ICMP) {
+            strcpy(name, "ICMP");
+        } else if (i == IP_PROTO_TCP) {
+            strcpy(name, "TCP");
+        } else if (i == IP_PROTO_UDP) {
+            strcpy(name, "UDP");
+        } else {
+            ksnprintf(name, sizeof(name), "%3d", i);
+        }
+        
+        print_counters(name, proto->rx_packets, proto->rx_bytes, proto->tx_packets, proto->tx_bytes);
+    }
+}
\ No newline at end of file
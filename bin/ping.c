@@ -3,46 +3,33 @@
 #include "../drivers/screen.h"
 #include "../drivers/network.h"
 #include "../net/icmp.h"
+#include "../net/ip.h"
 #include "../net/dns.h"
 #include "../net/ethernet.h"
 #include "../kernel/kernel.h"
+#include "../kernel/kprintf.h"
+#include "../kernel/thread.h"
+#include "../kernel/timer.h"
 
-static void print_ip(uint32_t ip) {
-    char buffer[16];
-    char num[4];
-    
-    buffer[0] = '\0';
-    
-    for (int i = 3; i >= 0; i--) {
-        uint8_t octet = (ip >> (i * 8)) & 0xFF;
-        int val = octet;
-        int len = 0;
-        
-        if (val == 0) {
-            num[len++] = '0';
-        } else {
-            char temp[4];
-            int tlen = 0;
-            while (val > 0) {
-                temp[tlen++] = '0' + (val % 10);
-                val /= 10;
-            }
-            while (tlen > 0) {
-                num[len++] = temp[--tlen];
+void cmd_ping(int argc, char** argv) {
+    const char* target = 0;
+    uint16_t payload_size = ICMP_ECHO_DEFAULT_PAYLOAD;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            int size = atoi(argv[++i]);
+            if (size < 0 || size > IP_MAX_PAYLOAD - (int)sizeof(icmp_header_t)) {
+                screen_print("ping: invalid packet size\n");
+                return;
             }
+            payload_size = size;
+        } else {
+            target = argv[i];
         }
-        num[len] = '\0';
-        
-        strcat(buffer, num);
-        if (i > 0) strcat(buffer, ".");
     }
     
-    screen_print(buffer);
-}
-
-void cmd_ping(int argc, char** argv) {
-    if (argc < 2) {
-        screen_print("Usage: ping <hostname or IP>\n");
+    if (!target) {
+        screen_print("Usage: ping [-s size] <hostname or IP>\n");
         return;
     }
     
@@ -59,21 +46,16 @@ void cmd_ping(int argc, char** argv) {
         return;
     }
     
-    screen_print("PING ");
-    screen_print(argv[1]);
-    screen_print("\n");
+    kprintf("PING %s\n", target);
     
     uint32_t target_ip;
-    if (!dns_resolve(argv[1], &target_ip)) {
-        screen_print("ping: cannot resolve ");
-        screen_print(argv[1]);
-        screen_print("\n");
+    if (!dns_resolve(target, &target_ip)) {
+        kprintf("ping: cannot resolve %s\n", target);
         return;
     }
     
-    screen_print("Pinging ");
-    print_ip(target_ip);
-    screen_print(" with 64 bytes of data:\n\n");
+    uint32_t packet_size = payload_size + sizeof(icmp_header_t);
+    kprintf("Pinging %I with %u bytes of data:\n\n", target_ip, packet_size);
     
     int count = 4;
     int received = 0;
@@ -82,40 +64,28 @@ void cmd_ping(int argc, char** argv) {
     for (int i = 0; i < count; i++) {
         uint16_t sequence = i + 1;
         
-        icmp_send_echo_request(target_ip, ping_id, sequence);
+        icmp_send_echo_request(target_ip, ping_id, sequence, payload_size);
         
-        uint32_t start_time = 0;
-        for (volatile int t = 0; t < 1000000; t++) start_time++;
+        uint32_t start_time = timer_get_ms();
         
         if (icmp_wait_reply(target_ip, sequence, 1000)) {
-            screen_print("Reply from ");
-            print_ip(target_ip);
-            screen_print(": bytes=64 time<1ms TTL=64\n");
+            uint32_t elapsed = timer_get_ms() - start_time;
+            // La resolución es la de un tick del temporizador
+            if (elapsed == 0) {
+                kprintf("Reply from %I: bytes=%u time<10ms TTL=64\n", target_ip, packet_size);
+            } else {
+                kprintf("Reply from %I: bytes=%u time=%ums TTL=64\n", target_ip, packet_size, elapsed);
+            }
             received++;
         } else {
             screen_print("Request timed out.\n");
         }
         
-        for (volatile int delay = 0; delay < 10000000; delay++);
+        if (i < count - 1) {
+            thread_sleep(1000);
+        }
     }
     
-    screen_print("\nPing statistics for ");
-    print_ip(target_ip);
-    screen_print(":\n");
-    screen_print("    Packets: Sent = ");
-    
-    char num[16];
-    num[0] = '0' + count;
-    num[1] = '\0';
-    screen_print(num);
-    
-    screen_print(", Received = ");
-    num[0] = '0' + received;
-    screen_print(num);
-    
-    screen_print(", Lost = ");
-    num[0] = '0' + (count - received);
-    screen_print(num);
-    
-    screen_print("\n");
+    kprintf("\nPing statistics for %I:\n", target_ip);
+    kprintf("    Packets: Sent = %d, Received = %d, Lost = %d\n", count, received, count - received);
 }
\ No newline at end of file
@@ -12,8 +12,6 @@ void cmd_reboot(int argc, char** argv) {
     temp |= 0xFE;
     asm volatile("outb %0, $0x64" : : "a"(temp));
 
-    asm volatile("int $0x19");
-
     while(1) {
         asm volatile("hlt");
     }
@@ -7,8 +7,9 @@ void cmd_shutdown(int argc, char** argv) {
     screen_print("Shutting down...\n");
     for (volatile int i = 0; i < 50000000; i++);
 
-    asm volatile("mov $0x2000, %ax; mov %ax, %dx; out %ax, %dx");
-    asm volatile("mov $0x5307, %ax; mov $0x0001, %bx; mov $0x0003, %cx; int $0x15");
+    // Puertos ACPI de QEMU (PIIX4) y Bochs; la APM de la BIOS no es accesible en modo protegido
+    asm volatile("outw %0, %1" : : "a"((uint16_t)0x2000), "Nd"((uint16_t)0x604));
+    asm volatile("outw %0, %1" : : "a"((uint16_t)0x2000), "Nd"((uint16_t)0xB004));
 
     while(1) {
         asm volatile("hlt");
@@ -0,0 +1,41 @@
+// bin/smp.c
+#include "commands.h"
+#include "../drivers/screen.h"
+#include "../kernel/smp.h"
+#include "../kernel/thread.h"
+#include "../kernel/kernel.h"
+#include "../kernel/kprintf.h"
+
+void cmd_smp(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    
+    screen_print("\nCPU  APIC  State     Queued  Switches  Steals   Busy%\n");
+    
+    for (int i = 0; i < smp_cpu_count(); i++) {
+        const cpu_local_t* cpu = smp_get_cpu(i);
+        sched_stats_t stats;
+        
+        kprintf("%3d%6u", i, cpu ? cpu->apic_id : 0);
+        
+        if (thread_get_cpu_stats(i, &stats) != 0) {
+            screen_print("  offline\n");
+            continue;
+        }
+        
+        uint32_t total = stats.busy_ticks + stats.idle_ticks;
+        kprintf("  %-8s%6u%10u%8u%8u\n", cpu && cpu->bsp ? "BSP" : "online",
+                stats.queued, stats.switches, stats.steals,
+                total ? stats.busy_ticks * 100 / total : 0);
+    }
+    
+    screen_print("\nThreads:\n");
+    for (int i = 0; i < THREAD_MAX; i++) {
+        thread_t* t = thread_get(i);
+        if (!t || t->state == THREAD_ZOMBIE) {
+            continue;
+        }
+        kprintf("  %s on CPU %d (%s)\n", t->name, t->cpu,
+                t->affinity == THREAD_ANY_CPU ? "any" : "pinned");
+    }
+}
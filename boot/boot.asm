@@ -4,6 +4,9 @@
 [BITS 16]
 [ORG 0x7C00]
 
+; Primera marca de tiempo del arranque (boot_info.boot_tsc[0], ver kernel/bootinfo.h)
+BOOT_TSC equ 0x5000 + 8 + 32 * 24
+
 start:
     cli
     xor ax, ax
@@ -13,6 +16,10 @@ start:
     mov sp, 0x7C00
     sti
 
+    rdtsc
+    mov [BOOT_TSC], eax
+    mov [BOOT_TSC + 4], edx
+
     mov si, boot_msg
     call print_string
 
@@ -4,16 +4,61 @@
 [BITS 16]
 [ORG 0x7E00]
 
+%include "kernel_size.inc"
+
+; Mapa de memoria E820 en BOOT_INFO: magic, count, entradas de 24 bytes
+BOOT_INFO       equ 0x5000
+BOOT_INFO_MAGIC equ 0x544F4F42
+E820_MAX        equ 32
+
+; Marcas de TSC por etapa tras el mapa E820 (stage1 escribe la primera)
+BOOT_TSC        equ BOOT_INFO + 8 + E820_MAX * 24
+BOOT_TSC_STAGE2 equ BOOT_TSC + 8
+
+; Modo de vídeo elegido, tras las cuatro marcas de TSC (ver kernel/bootinfo.h)
+BOOT_VIDEO      equ BOOT_TSC + 4 * 8
+FB_ADDR         equ BOOT_VIDEO
+FB_PITCH        equ BOOT_VIDEO + 4
+FB_WIDTH        equ BOOT_VIDEO + 8
+FB_HEIGHT       equ BOOT_VIDEO + 10
+FB_BPP          equ BOOT_VIDEO + 12
+FONT_HEIGHT     equ BOOT_VIDEO + 13
+FONT_PTR        equ BOOT_VIDEO + 16
+
+; Buffers de trabajo de VBE y copia de la fuente 8x16 de la BIOS
+VBE_INFO        equ 0x5400
+VBE_MODE_INFO   equ 0x5600
+FONT_ADDR       equ 0x6000
+VIDEO_MAX_WIDTH  equ 1024
+VIDEO_MAX_HEIGHT equ 768
+
+; El kernel va justo detrás de stage2 (LBA 16) y se carga en 0x10000
+KERNEL_LBA      equ 16
+KERNEL_SEGMENT  equ 0x1000
+
+%if KERNEL_SECTORS > (0x80000 - 0x10000) / 512
+%error "kernel.bin no cabe por debajo de 0x80000"
+%endif
+
 stage2_start:
+    mov [boot_drive], dl
+    rdtsc
+    mov [BOOT_TSC_STAGE2], eax
+    mov [BOOT_TSC_STAGE2 + 4], edx
+
     mov si, stage2_msg
     call print_string
 
     call enable_a20
+    call detect_memory
     call load_kernel
 
     mov si, kernel_loaded_msg
     call print_string
 
+    ; Después ya no se puede escribir con la BIOS: el modo gráfico va lo último
+    call setup_video
+
     cli
     lgdt [gdt_descriptor]
 
@@ -29,16 +74,284 @@ enable_a20:
     out 0x92, al
     ret
 
+detect_memory:
+    xor ax, ax
+    mov es, ax
+    mov dword [BOOT_INFO], BOOT_INFO_MAGIC
+    mov dword [BOOT_INFO + 4], 0
+    mov di, BOOT_INFO + 8
+    xor ebx, ebx
+.next:
+    mov eax, 0xE820
+    mov edx, 0x534D4150         ; 'SMAP'
+    mov ecx, 24
+    mov dword [es:di + 20], 1   ; ACPI 3.0: entrada válida si la BIOS no lo toca
+    int 0x15
+    jc .done
+    cmp eax, 0x534D4150
+    jne .done
+    mov eax, [es:di + 8]        ; descartar entradas de longitud cero
+    or eax, [es:di + 12]
+    jz .skip
+    inc dword [BOOT_INFO + 4]
+    add di, 24
+    cmp dword [BOOT_INFO + 4], E820_MAX
+    jae .done
+.skip:
+    test ebx, ebx
+    jnz .next
+.done:
+    ret
+
+; Carga KERNEL_SECTORS sectores con INT 13h AH=42h si hay extensiones y si no
+; con lecturas CHS de pista completa; ningún bloque cruza un límite de 64 KB (DMA)
 load_kernel:
-    mov ah, 0x02
-    mov al, 80
-    mov ch, 0
-    mov cl, 17
-    mov dh, 0
-    mov bx, 0x1000
-    mov es, bx
+    mov dword [load_lba], KERNEL_LBA
+    mov word [load_segment], KERNEL_SEGMENT
+    mov word [load_remaining], KERNEL_SECTORS
+
+    mov ah, 0x41
+    mov bx, 0x55AA
+    mov dl, [boot_drive]
+    int 0x13
+    jc .geometry
+    cmp bx, 0xAA55
+    jne .geometry
+    test cx, 1                  ; acceso por paquetes (AH=42h)
+    jz .geometry
+    mov byte [use_lba], 1
+    jmp .next
+
+.geometry:
+    ; Geometría pedida una sola vez a la BIOS; por defecto disquete de 1.44 MB
+    mov word [sectors_per_track], 18
+    mov word [heads], 2
+    mov ah, 0x08
+    mov dl, [boot_drive]
+    xor di, di
+    mov es, di
+    int 0x13
+    jc .next
+    and cx, 0x3F
+    jz .next
+    mov [sectors_per_track], cx
+    movzx ax, dh
+    inc ax
+    mov [heads], ax
+
+.next:
+    cmp word [load_remaining], 0
+    je .done
+    call load_chunk_size
+    mov [load_count], ax
+    mov byte [load_retries], 3
+
+.retry:
+    cmp byte [use_lba], 0
+    je .read_chs
+
+    mov ax, [load_count]
+    mov [dap_count], ax
+    mov ax, [load_segment]
+    mov [dap_segment], ax
+    mov eax, [load_lba]
+    mov [dap_lba], eax
+    mov si, dap
+    mov ah, 0x42
+    mov dl, [boot_drive]
+    int 0x13
+    jnc .advance
+    jmp .failed
+
+.read_chs:
+    mov eax, [load_lba]
+    xor edx, edx
+    movzx ebx, word [sectors_per_track]
+    div ebx                     ; EAX = pista lógica, EDX = sector - 1
+    mov cl, dl
+    inc cl
+    xor edx, edx
+    movzx ebx, word [heads]
+    div ebx                     ; EAX = cilindro, EDX = cabeza
+    mov dh, dl
+    mov ch, al
+    shl ah, 6                   ; bits 8-9 del cilindro en CL
+    or cl, ah
+    mov ax, [load_segment]
+    mov es, ax
     xor bx, bx
+    mov al, [load_count]
+    mov ah, 0x02
+    mov dl, [boot_drive]
+    int 0x13
+    jnc .advance
+
+.failed:
+    xor ah, ah
+    mov dl, [boot_drive]
     int 0x13
+    dec byte [load_retries]
+    jnz .retry
+    mov si, disk_error_msg
+    call print_string
+.halt:
+    cli
+    hlt
+    jmp .halt
+
+.advance:
+    movzx eax, word [load_count]
+    add [load_lba], eax
+    sub [load_remaining], ax
+    shl ax, 5                   ; 512 bytes = 32 párrafos
+    add [load_segment], ax
+    jmp .next
+
+.done:
+    ret
+
+; Copia la fuente 8x16 de la BIOS y pasa al mayor modo VBE lineal de 32 bpp
+; que no supere VIDEO_MAX_WIDTH x VIDEO_MAX_HEIGHT. FB_ADDR = 0: modo texto
+setup_video:
+    mov dword [FB_ADDR], 0
+    mov dword [FONT_PTR], 0
+%ifndef TEXT_CONSOLE
+    push ds
+    mov ax, 0x1130
+    mov bh, 0x06
+    int 0x10                    ; ES:BP = fuente, CX = bytes por carácter
+    cmp cx, 16
+    jne .no_font
+    push es
+    pop ds
+    mov si, bp
+    xor ax, ax
+    mov es, ax
+    mov di, FONT_ADDR
+    mov cx, 256 * 16 / 2
+    cld
+    rep movsw
+    pop ds
+    mov dword [FONT_PTR], FONT_ADDR
+    mov byte [FONT_HEIGHT], 16
+
+    xor ax, ax
+    mov es, ax
+    mov di, VBE_INFO
+    mov dword [VBE_INFO], 'VBE2'
+    mov ax, 0x4F00
+    int 0x10
+    cmp ax, 0x004F
+    jne .done
+    cmp dword [VBE_INFO], 'VESA'
+    jne .done
+
+    mov word [video_best_mode], 0xFFFF
+    mov word [video_best_width], 0
+    mov si, [VBE_INFO + 14]     ; lista de modos (puntero lejano)
+    mov ax, [VBE_INFO + 16]
+    mov fs, ax
+
+.next_mode:
+    mov cx, [fs:si]
+    cmp cx, 0xFFFF
+    je .set_mode
+    add si, 2
+    mov [video_mode], cx
+    push si
+    push fs
+    mov ax, 0x4F01
+    mov di, VBE_MODE_INFO
+    int 0x10
+    pop fs
+    pop si
+    cmp ax, 0x004F
+    jne .next_mode
+    mov ax, [VBE_MODE_INFO]
+    and ax, 0x0091              ; soportado, gráfico, framebuffer lineal
+    cmp ax, 0x0091
+    jne .next_mode
+    cmp byte [VBE_MODE_INFO + 25], 32
+    jne .next_mode
+    mov ax, [VBE_MODE_INFO + 18]
+    cmp ax, VIDEO_MAX_WIDTH
+    ja .next_mode
+    cmp word [VBE_MODE_INFO + 20], VIDEO_MAX_HEIGHT
+    ja .next_mode
+    cmp ax, [video_best_width]
+    jbe .next_mode
+    mov [video_best_width], ax
+    mov ax, [video_mode]
+    mov [video_best_mode], ax
+    jmp .next_mode
+
+.set_mode:
+    mov cx, [video_best_mode]
+    cmp cx, 0xFFFF
+    je .done
+    mov ax, 0x4F01
+    mov di, VBE_MODE_INFO
+    int 0x10
+    cmp ax, 0x004F
+    jne .done
+    mov ax, 0x4F02
+    mov bx, [video_best_mode]
+    or bx, 0x4000               ; framebuffer lineal
+    int 0x10
+    cmp ax, 0x004F
+    jne .done
+
+    mov eax, [VBE_MODE_INFO + 40]
+    mov [FB_ADDR], eax
+    movzx eax, word [VBE_MODE_INFO + 16]
+    mov [FB_PITCH], eax
+    mov ax, [VBE_MODE_INFO + 18]
+    mov [FB_WIDTH], ax
+    mov ax, [VBE_MODE_INFO + 20]
+    mov [FB_HEIGHT], ax
+    mov al, [VBE_MODE_INFO + 25]
+    mov [FB_BPP], al
+    jmp .done
+
+.no_font:
+    pop ds
+.done:
+    xor ax, ax
+    mov es, ax
+%endif
+    ret
+
+; AX = sectores del siguiente bloque: lo que falta, sin pasar del límite de
+; 64 KB ni de 127 sectores (LBA) o del final de la pista (CHS)
+load_chunk_size:
+    mov ax, [load_remaining]
+    mov cx, [load_segment]
+    and cx, 0x0FFF
+    neg cx
+    add cx, 0x1000
+    shr cx, 5
+    cmp ax, cx
+    jbe .limit
+    mov ax, cx
+.limit:
+    cmp byte [use_lba], 0
+    je .track
+    cmp ax, 127
+    jbe .ret
+    mov ax, 127
+    ret
+.track:
+    mov cx, ax
+    mov eax, [load_lba]
+    xor edx, edx
+    movzx ebx, word [sectors_per_track]
+    div ebx
+    mov ax, [sectors_per_track]
+    sub ax, dx
+    cmp ax, cx
+    jbe .ret
+    mov ax, cx
+.ret:
     ret
 
 print_string:
@@ -53,6 +366,28 @@ print_string:
 
 stage2_msg db 'Stage 2 loaded. Loading kernel...', 13, 10, 0
 kernel_loaded_msg db 'Kernel loaded. Entering protected mode...', 13, 10, 0
+disk_error_msg db 'Kernel read error!', 13, 10, 0
+
+boot_drive        db 0
+use_lba           db 0
+load_retries      db 0
+sectors_per_track dw 18
+heads             dw 2
+load_lba          dd 0
+load_segment      dw 0
+load_remaining    dw 0
+load_count        dw 0
+video_mode        dw 0
+video_best_mode   dw 0
+video_best_width  dw 0
+
+; Disk Address Packet para INT 13h AH=42h
+dap:
+    db 16, 0
+dap_count   dw 0
+dap_offset  dw 0
+dap_segment dw 0
+dap_lba     dd 0, 0
 
 gdt_start:
     dq 0
@@ -92,7 +427,8 @@ protected_mode_start:
     mov ss, ax
     mov esp, 0x90000
 
-    ; Jump to kernel entry point
+    ; Jump to kernel entry point (EBX = boot_info)
+    mov ebx, BOOT_INFO
     jmp CODE_SEG:0x10000
 
 times 7680-($-$$) db 0
\ No newline at end of file
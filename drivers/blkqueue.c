@@ -0,0 +1,265 @@
+// drivers/blkqueue.c
+#include "blkqueue.h"
+#include "../kernel/memory.h"
+
+static blk_request_t requests[BLKQ_MAX_REQUESTS];
+static uint32_t dispatch_count = 0;
+static uint32_t head_lba = 0;
+static int last_status = 0;
+
+#define BLKQ_POOL_BYTES (BLKQ_POOL_SECTORS * BLOCKDEV_SECTOR_SIZE)
+#define BLKQ_MERGE_BYTES (BLKQ_MERGE_SECTORS * BLOCKDEV_SECTOR_SIZE)
+
+// Pool y buffer de fusión en páginas reservadas; sin memoria la cola trabaja sin agrupar
+static uint8_t* write_pool = 0;
+static uint32_t pool_size = 0;
+static uint32_t pool_used = 0;
+static uint8_t* merge_buffer = 0;
+
+void blkq_init(void) {
+    for (int i = 0; i < BLKQ_MAX_REQUESTS; i++) {
+        requests[i].in_use = 0;
+    }
+    dispatch_count = 0;
+    head_lba = 0;
+    pool_used = 0;
+    last_status = 0;
+    
+    if (!write_pool) {
+        uint8_t* mem = kmem_alloc(BLKQ_POOL_BYTES + BLKQ_MERGE_BYTES);
+        if (mem) {
+            write_pool = mem;
+            pool_size = BLKQ_POOL_BYTES;
+            merge_buffer = mem + BLKQ_POOL_BYTES;
+        }
+    }
+}
+
+static int blkq_pending(blockdev_t* dev) {
+    for (int i = 0; i < BLKQ_MAX_REQUESTS; i++) {
+        if (requests[i].in_use && (!dev || requests[i].dev == dev)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static blk_request_t* blkq_alloc(void) {
+    for (int i = 0; i < BLKQ_MAX_REQUESTS; i++) {
+        if (!requests[i].in_use) {
+            return &requests[i];
+        }
+    }
+    return 0;
+}
+
+static void blkq_complete(blk_request_t* req, int status) {
+    req->in_use = 0;
+    if (status != 0) {
+        last_status = status;
+    }
+    if (req->callback) {
+        req->callback(req, status);
+    }
+    
+    // El pool de escrituras se recicla entero cuando la cola queda vacía
+    if (!blkq_pending(0)) {
+        pool_used = 0;
+    }
+}
+
+// Elevador: C-LOOK desde la posición del cabezal salvo que haya una petición caducada
+static blk_request_t* blkq_choose(blockdev_t* dev) {
+    blk_request_t* oldest = 0;
+    blk_request_t* ahead = 0;
+    blk_request_t* lowest = 0;
+    
+    for (int i = 0; i < BLKQ_MAX_REQUESTS; i++) {
+        blk_request_t* req = &requests[i];
+        if (!req->in_use || req->dev != dev) continue;
+        
+        if (!oldest || req->seq < oldest->seq) oldest = req;
+        if (!lowest || req->lba < lowest->lba) lowest = req;
+        if (req->lba >= head_lba && (!ahead || req->lba < ahead->lba)) ahead = req;
+    }
+    
+    if (oldest && dispatch_count - oldest->seq > BLKQ_FIFO_EXPIRE) {
+        return oldest;
+    }
+    
+    return ahead ? ahead : lowest;
+}
+
+static blk_request_t* blkq_find_next(blockdev_t* dev, int op, uint32_t lba) {
+    for (int i = 0; i < BLKQ_MAX_REQUESTS; i++) {
+        blk_request_t* req = &requests[i];
+        if (req->in_use && req->dev == dev && req->op == op && req->lba == lba) {
+            return req;
+        }
+    }
+    return 0;
+}
+
+static int blkq_do_io(blockdev_t* dev, int op, uint32_t lba, uint32_t count, uint8_t* buffer) {
+    if (op == BLK_OP_WRITE) {
+        return blockdev_write(dev, lba, count, buffer);
+    }
+    return blockdev_read(dev, lba, count, buffer);
+}
+
+// Despacha la petición elegida junto con las contiguas del mismo tipo en una sola transferencia
+static void blkq_dispatch_one(blockdev_t* dev, blk_request_t* first) {
+    blk_request_t* run[BLKQ_MAX_REQUESTS];
+    int run_len = 1;
+    uint32_t total = first->count;
+    
+    run[0] = first;
+    
+    while (merge_buffer && run_len < BLKQ_MAX_REQUESTS) {
+        blk_request_t* next = blkq_find_next(dev, first->op, first->lba + total);
+        if (!next || total + next->count > BLKQ_MERGE_SECTORS) break;
+        run[run_len++] = next;
+        total += next->count;
+    }
+    
+    dispatch_count++;
+    head_lba = first->lba + total;
+    
+    if (run_len == 1) {
+        int status = blkq_do_io(dev, first->op, first->lba, first->count, first->buffer);
+        blkq_complete(first, status);
+        return;
+    }
+    
+    uint32_t offset = 0;
+    if (first->op == BLK_OP_WRITE) {
+        for (int i = 0; i < run_len; i++) {
+            memcpy(merge_buffer + offset, run[i]->buffer, run[i]->count * BLOCKDEV_SECTOR_SIZE);
+            offset += run[i]->count * BLOCKDEV_SECTOR_SIZE;
+        }
+    }
+    
+    int status = blkq_do_io(dev, first->op, first->lba, total, merge_buffer);
+    
+    offset = 0;
+    for (int i = 0; i < run_len; i++) {
+        if (first->op == BLK_OP_READ) {
+            memcpy(run[i]->buffer, merge_buffer + offset, run[i]->count * BLOCKDEV_SECTOR_SIZE);
+            offset += run[i]->count * BLOCKDEV_SECTOR_SIZE;
+        }
+        blkq_complete(run[i], status);
+    }
+}
+
+void blkq_run(blockdev_t* dev) {
+    blk_request_t* req;
+    while ((req = blkq_choose(dev)) != 0) {
+        blkq_dispatch_one(dev, req);
+    }
+}
+
+int blkq_submit(blockdev_t* dev, int op, uint32_t lba, uint32_t count, uint8_t* buffer,
+                blk_callback_t callback, void* ctx) {
+    if (!dev || count == 0) {
+        return -1;
+    }
+    
+    blk_request_t* req = blkq_alloc();
+    if (!req) {
+        // Cola llena: vaciarla antes de aceptar más trabajo
+        blkq_run(dev);
+        req = blkq_alloc();
+        if (!req) {
+            return -1;
+        }
+    }
+    
+    req->dev = dev;
+    req->op = op;
+    req->lba = lba;
+    req->count = count;
+    req->buffer = buffer;
+    req->seq = dispatch_count;
+    req->callback = callback;
+    req->ctx = ctx;
+    req->in_use = 1;
+    
+    return 0;
+}
+
+static int blkq_overlaps(const blk_request_t* req, uint32_t lba, uint32_t count) {
+    return req->lba < lba + count && lba < req->lba + req->count;
+}
+
+int blkq_read(blockdev_t* dev, uint32_t lba, uint32_t count, uint8_t* buffer) {
+    // Las escrituras encoladas sobre el mismo rango deben llegar antes al disco
+    for (int i = 0; i < BLKQ_MAX_REQUESTS; i++) {
+        blk_request_t* req = &requests[i];
+        if (req->in_use && req->dev == dev && req->op == BLK_OP_WRITE &&
+            blkq_overlaps(req, lba, count)) {
+            blkq_run(dev);
+            break;
+        }
+    }
+    
+    return blockdev_read(dev, lba, count, buffer);
+}
+
+int blkq_write(blockdev_t* dev, uint32_t lba, uint32_t count, const uint8_t* buffer) {
+    if (!dev || count == 0) {
+        return -1;
+    }
+    
+    uint32_t bytes = count * BLOCKDEV_SECTOR_SIZE;
+    
+    for (int i = 0; i < BLKQ_MAX_REQUESTS; i++) {
+        blk_request_t* req = &requests[i];
+        if (!req->in_use || req->dev != dev || !blkq_overlaps(req, lba, count)) continue;
+        
+        // Reescritura del mismo rango: basta con actualizar los datos encolados
+        if (req->op == BLK_OP_WRITE && req->lba == lba && req->count == count && !req->callback) {
+            memcpy(req->buffer, buffer, bytes);
+            return 0;
+        }
+        
+        // Cualquier otro solapamiento: respetar el orden despachando lo anterior
+        blkq_run(dev);
+        break;
+    }
+    
+    // Transferencias mayores que el pool van directas al disco
+    if (count > BLKQ_POOL_SECTORS) {
+        blkq_run(dev);
+        return blockdev_write(dev, lba, count, buffer);
+    }
+    
+    if (pool_used + bytes > pool_size) {
+        blkq_run(dev);
+        if (pool_used + bytes > pool_size) {
+            // Otro dispositivo ocupa el pool
+            return blockdev_write(dev, lba, count, buffer);
+        }
+    }
+    
+    uint8_t* data = write_pool + pool_used;
+    memcpy(data, buffer, bytes);
+    
+    if (blkq_submit(dev, BLK_OP_WRITE, lba, count, data, 0, 0) != 0) {
+        return blockdev_write(dev, lba, count, buffer);
+    }
+    
+    pool_used += bytes;
+    return 0;
+}
+
+// El error de escrituras despachadas antes (pool lleno, solapamientos) se conserva hasta aquí
+int blkq_flush(blockdev_t* dev) {
+    blkq_run(dev);
+    
+    int status = last_status;
+    last_status = 0;
+    if (blockdev_flush(dev) != 0) {
+        status = -1;
+    }
+    return status;
+}
@@ -0,0 +1,48 @@
+// drivers/blkqueue.h
+#ifndef BLKQUEUE_H
+#define BLKQUEUE_H
+
+#include "blockdev.h"
+
+#define BLK_OP_READ 0
+#define BLK_OP_WRITE 1
+
+#define BLKQ_MAX_REQUESTS 32
+// Memoria donde se copian los datos de las escrituras encoladas
+#define BLKQ_POOL_SECTORS 64
+// Tamaño máximo de una transferencia formada al fusionar peticiones
+#define BLKQ_MERGE_SECTORS 32
+// Peticiones despachadas antes de que una petición antigua pase delante
+#define BLKQ_FIFO_EXPIRE 16
+
+typedef struct blk_request blk_request_t;
+typedef void (*blk_callback_t)(blk_request_t* req, int status);
+
+struct blk_request {
+    blockdev_t* dev;
+    int op;
+    uint32_t lba;
+    uint32_t count;
+    uint8_t* buffer;
+    uint32_t seq;
+    blk_callback_t callback;
+    void* ctx;
+    int in_use;
+};
+
+void blkq_init(void);
+
+// Asíncronas: la petición se completa (y se llama al callback) al despacharla
+int blkq_submit(blockdev_t* dev, int op, uint32_t lba, uint32_t count, uint8_t* buffer,
+                blk_callback_t callback, void* ctx);
+void blkq_run(blockdev_t* dev);
+
+// Lectura síncrona: la cola solo se vacía si alguna escritura pendiente la solapa
+int blkq_read(blockdev_t* dev, uint32_t lba, uint32_t count, uint8_t* buffer);
+// Escritura diferida: los datos se copian y el llamador puede reutilizar su buffer
+int blkq_write(blockdev_t* dev, uint32_t lba, uint32_t count, const uint8_t* buffer);
+// Despacha todo lo pendiente en orden de sector y vacía la caché del disco;
+// devuelve -1 si falló cualquier escritura diferida desde el flush anterior
+int blkq_flush(blockdev_t* dev);
+
+#endif
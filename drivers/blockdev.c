@@ -0,0 +1,114 @@
+// drivers/blockdev.c
+#include "blockdev.h"
+#include "blkqueue.h"
+#include "disk.h"
+#include "virtio_blk.h"
+#include "screen.h"
+#include "../kernel/kprintf.h"
+
+static blockdev_t* blockdevs[BLOCKDEV_MAX];
+static int blockdev_total = 0;
+static blockdev_t* default_dev = 0;
+
+void blockdev_init(void) {
+    blockdev_total = 0;
+    default_dev = 0;
+    blkq_init();
+    
+    // El primer dispositivo registrado es el que usa el sistema de archivos
+    virtio_blk_probe();
+    disk_init();
+    
+    if (blockdev_total == 0) {
+        screen_print("[BLK] No block devices found\n");
+    }
+}
+
+int blockdev_register(blockdev_t* dev) {
+    if (blockdev_total >= BLOCKDEV_MAX) {
+        return -1;
+    }
+    
+    blockdevs[blockdev_total++] = dev;
+    if (!default_dev) {
+        default_dev = dev;
+    }
+    
+    kprintf("[BLK] %s (%s)", dev->name, dev->driver);
+    if (dev->sector_count) {
+        kprintf(" %u sectors", dev->sector_count);
+    }
+    kprintf("%s\n", dev->read_only ? " read-only" : "");
+    
+    return 0;
+}
+
+int blockdev_count(void) {
+    return blockdev_total;
+}
+
+blockdev_t* blockdev_get(int index) {
+    if (index < 0 || index >= blockdev_total) {
+        return 0;
+    }
+    return blockdevs[index];
+}
+
+blockdev_t* blockdev_find(const char* name) {
+    for (int i = 0; i < blockdev_total; i++) {
+        if (strcmp(blockdevs[i]->name, name) == 0) {
+            return blockdevs[i];
+        }
+    }
+    return 0;
+}
+
+blockdev_t* blockdev_default(void) {
+    return default_dev;
+}
+
+void blockdev_set_default(blockdev_t* dev) {
+    default_dev = dev;
+}
+
+static int blockdev_check_range(blockdev_t* dev, uint32_t lba, uint32_t count) {
+    if (!dev) {
+        return 0;
+    }
+    // sector_count == 0 significa capacidad desconocida
+    if (dev->sector_count && (lba >= dev->sector_count || count > dev->sector_count - lba)) {
+        return 0;
+    }
+    return 1;
+}
+
+int blockdev_read(blockdev_t* dev, uint32_t lba, uint32_t count, uint8_t* buffer) {
+    if (!blockdev_check_range(dev, lba, count)) {
+        memset(buffer, 0, count * BLOCKDEV_SECTOR_SIZE);
+        return -1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    return dev->ops->read(dev, lba, count, buffer);
+}
+
+int blockdev_write(blockdev_t* dev, uint32_t lba, uint32_t count, const uint8_t* buffer) {
+    if (!blockdev_check_range(dev, lba, count) || dev->read_only) {
+        return -1;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    return dev->ops->write(dev, lba, count, buffer);
+}
+
+int blockdev_flush(blockdev_t* dev) {
+    if (!dev) {
+        return -1;
+    }
+    if (!dev->ops->flush) {
+        return 0;
+    }
+    return dev->ops->flush(dev);
+}
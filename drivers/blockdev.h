@@ -0,0 +1,41 @@
+// drivers/blockdev.h
+#ifndef BLOCKDEV_H
+#define BLOCKDEV_H
+
+#include "../kernel/kernel.h"
+
+#define BLOCKDEV_SECTOR_SIZE 512
+#define BLOCKDEV_MAX 4
+#define BLOCKDEV_NAME_LEN 8
+
+typedef struct blockdev blockdev_t;
+
+// Operaciones que implementa cada driver de disco (0 = éxito, -1 = error)
+typedef struct {
+    int (*read)(blockdev_t* dev, uint32_t lba, uint32_t count, uint8_t* buffer);
+    int (*write)(blockdev_t* dev, uint32_t lba, uint32_t count, const uint8_t* buffer);
+    int (*flush)(blockdev_t* dev);
+} blockdev_ops_t;
+
+struct blockdev {
+    char name[BLOCKDEV_NAME_LEN];
+    const char* driver;
+    uint32_t sector_count;
+    int read_only;
+    const blockdev_ops_t* ops;
+    void* priv;
+};
+
+void blockdev_init(void);
+int blockdev_register(blockdev_t* dev);
+int blockdev_count(void);
+blockdev_t* blockdev_get(int index);
+blockdev_t* blockdev_find(const char* name);
+blockdev_t* blockdev_default(void);
+void blockdev_set_default(blockdev_t* dev);
+
+int blockdev_read(blockdev_t* dev, uint32_t lba, uint32_t count, uint8_t* buffer);
+int blockdev_write(blockdev_t* dev, uint32_t lba, uint32_t count, const uint8_t* buffer);
+int blockdev_flush(blockdev_t* dev);
+
+#endif
@@ -1,4 +1,10 @@
 #include "disk.h"
+#include "blockdev.h"
+#include "screen.h"
+#include "../kernel/kprintf.h"
+
+static ata_info_t ata;
+static blockdev_t ata_blockdev;
 
 static void outb(uint16_t port, uint8_t value) {
     asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
@@ -14,105 +20,302 @@ static void insw(uint16_t port, uint16_t* buffer, uint32_t count) {
     asm volatile("rep insw" : "+D"(buffer), "+c"(count) : "d"(port) : "memory");
 }
 
-static void outsw(uint16_t port, uint16_t* buffer, uint32_t count) {
+static void outsw(uint16_t port, const uint16_t* buffer, uint32_t count) {
     asm volatile("rep outsw" : "+S"(buffer), "+c"(count) : "d"(port) : "memory");
 }
 
 static void io_wait(void) {
-    for (volatile int i = 0; i < 100; i++);
+    // Cuatro lecturas del estado alternativo equivalen a los 400ns que exige el estándar
+    for (int i = 0; i < 4; i++) {
+        inb(0x3F6);
+    }
 }
 
 static int ata_wait_bsy(void) {
     for (int i = 0; i < 10000000; i++) {
-        uint8_t status = inb(0x1F7);
-        if (!(status & 0x80)) {
+        uint8_t status = inb(ATA_STATUS);
+        if (!(status & ATA_SR_BSY)) {
             return 1;
         }
-        io_wait();
     }
     return 0;
 }
 
 static int ata_wait_drq(void) {
     for (int i = 0; i < 10000000; i++) {
-        uint8_t status = inb(0x1F7);
-        if (status & 0x08) {
-            return 1;
-        }
-        if (status & 0x01) {
+        uint8_t status = inb(ATA_STATUS);
+        if (status & (ATA_SR_ERR | ATA_SR_DF)) {
             return 0;
         }
-        io_wait();
+        if (!(status & ATA_SR_BSY) && (status & ATA_SR_DRQ)) {
+            return 1;
+        }
     }
     return 0;
 }
 
-void disk_read_sectors(uint32_t lba, uint8_t sector_count, uint8_t* buffer) {
-    if (!ata_wait_bsy()) {
-        for (int i = 0; i < sector_count * 512; i++) {
-            buffer[i] = 0;
-        }
-        return;
+static void ata_select_lba(uint32_t lba, uint32_t count, int lba48) {
+    if (lba48) {
+        // LBA48: primero los bytes altos, después los bajos, en los mismos registros
+        outb(ATA_DRIVE_HEAD, 0x40);
+        io_wait();
+        outb(ATA_SECTOR_CNT, (uint8_t)(count >> 8));
+        outb(ATA_LBA_LOW, (uint8_t)(lba >> 24));
+        outb(ATA_LBA_MID, 0);
+        outb(ATA_LBA_HIGH, 0);
+        outb(ATA_SECTOR_CNT, (uint8_t)count);
+        outb(ATA_LBA_LOW, (uint8_t)lba);
+        outb(ATA_LBA_MID, (uint8_t)(lba >> 8));
+        outb(ATA_LBA_HIGH, (uint8_t)(lba >> 16));
+    } else {
+        outb(ATA_DRIVE_HEAD, 0xE0 | ((lba >> 24) & 0x0F));
+        io_wait();
+        outb(ATA_SECTOR_CNT, (uint8_t)count);
+        outb(ATA_LBA_LOW, (uint8_t)lba);
+        outb(ATA_LBA_MID, (uint8_t)(lba >> 8));
+        outb(ATA_LBA_HIGH, (uint8_t)(lba >> 16));
     }
+}
 
-    outb(0x1F6, 0xE0 | ((lba >> 24) & 0x0F));
-    io_wait();
-    outb(0x1F2, sector_count);
-    outb(0x1F3, (uint8_t)lba);
-    outb(0x1F4, (uint8_t)(lba >> 8));
-    outb(0x1F5, (uint8_t)(lba >> 16));
-    outb(0x1F7, 0x20);
-    io_wait();
+static int ata_use_lba48(uint32_t lba, uint32_t count) {
+    return ata.lba48 && (lba + count > 0x0FFFFFFF || count > 256);
+}
 
-    for (int i = 0; i < sector_count; i++) {
-        if (!ata_wait_bsy()) {
-            for (int j = i * 512; j < sector_count * 512; j++) {
-                buffer[j] = 0;
-            }
-            return;
-        }
+static uint8_t ata_read_command(int lba48) {
+    if (ata.multiple > 1) {
+        return lba48 ? ATA_CMD_READ_MULTIPLE_EXT : ATA_CMD_READ_MULTIPLE;
+    }
+    return lba48 ? ATA_CMD_READ_SECTORS_EXT : ATA_CMD_READ_SECTORS;
+}
+
+static uint8_t ata_write_command(int lba48) {
+    if (ata.multiple > 1) {
+        return lba48 ? ATA_CMD_WRITE_MULTIPLE_EXT : ATA_CMD_WRITE_MULTIPLE;
+    }
+    return lba48 ? ATA_CMD_WRITE_SECTORS_EXT : ATA_CMD_WRITE_SECTORS;
+}
+
+// Un comando: hasta 256 sectores en LBA28 o 65536 en LBA48
+static int ata_read_cmd(uint32_t lba, uint32_t count, uint8_t* buffer) {
+    int lba48 = ata_use_lba48(lba, count);
+    
+    if (!ata_wait_bsy()) {
+        return -1;
+    }
+    
+    ata_select_lba(lba, count, lba48);
+    outb(ATA_COMMAND, ata_read_command(lba48));
+    io_wait();
+    
+    // Con READ MULTIPLE cada DRQ entrega un bloque de 'multiple' sectores
+    uint32_t block = ata.multiple > 1 ? ata.multiple : 1;
+    
+    while (count > 0) {
+        uint32_t n = count < block ? count : block;
         
         if (!ata_wait_drq()) {
-            for (int j = i * 512; j < sector_count * 512; j++) {
-                buffer[j] = 0;
-            }
-            return;
+            return -1;
         }
         
-        insw(0x1F0, (uint16_t*)(buffer + i * 512), 256);
-        io_wait();
+        insw(ATA_DATA, (uint16_t*)buffer, n * 256);
+        buffer += n * 512;
+        count -= n;
     }
+    
+    return 0;
 }
 
-void disk_write_sectors(uint32_t lba, uint8_t sector_count, uint8_t* buffer) {
+static int ata_write_cmd(uint32_t lba, uint32_t count, const uint8_t* buffer) {
+    int lba48 = ata_use_lba48(lba, count);
+    
     if (!ata_wait_bsy()) {
-        return;
+        return -1;
     }
-
-    outb(0x1F6, 0xE0 | ((lba >> 24) & 0x0F));
-    io_wait();
-    outb(0x1F2, sector_count);
-    outb(0x1F3, (uint8_t)lba);
-    outb(0x1F4, (uint8_t)(lba >> 8));
-    outb(0x1F5, (uint8_t)(lba >> 16));
-    outb(0x1F7, 0x30);
+    
+    ata_select_lba(lba, count, lba48);
+    outb(ATA_COMMAND, ata_write_command(lba48));
     io_wait();
+    
+    uint32_t block = ata.multiple > 1 ? ata.multiple : 1;
+    
+    while (count > 0) {
+        uint32_t n = count < block ? count : block;
+        
+        if (!ata_wait_drq()) {
+            return -1;
+        }
+        
+        outsw(ATA_DATA, (const uint16_t*)buffer, n * 256);
+        buffer += n * 512;
+        count -= n;
+    }
+    
+    if (!ata_wait_bsy()) {
+        return -1;
+    }
+    
+    outb(ATA_COMMAND, lba48 ? ATA_CMD_CACHE_FLUSH_EXT : ATA_CMD_CACHE_FLUSH);
+    ata_wait_bsy();
+    
+    return 0;
+}
 
-    for (int i = 0; i < sector_count; i++) {
-        if (!ata_wait_bsy()) {
-            return;
+static uint32_t ata_max_per_cmd(void) {
+    return ata.lba48 ? 65536 : 256;
+}
+
+int disk_read_sectors(uint32_t lba, uint32_t sector_count, uint8_t* buffer) {
+    while (sector_count > 0) {
+        uint32_t chunk = sector_count < ata_max_per_cmd() ? sector_count : ata_max_per_cmd();
+        
+        if (ata_read_cmd(lba, chunk, buffer) != 0) {
+            memset(buffer, 0, sector_count * 512);
+            return -1;
         }
         
-        if (!ata_wait_drq()) {
-            return;
+        lba += chunk;
+        sector_count -= chunk;
+        buffer += chunk * 512;
+    }
+    return 0;
+}
+
+int disk_write_sectors(uint32_t lba, uint32_t sector_count, const uint8_t* buffer) {
+    while (sector_count > 0) {
+        uint32_t chunk = sector_count < ata_max_per_cmd() ? sector_count : ata_max_per_cmd();
+        
+        if (ata_write_cmd(lba, chunk, buffer) != 0) {
+            return -1;
         }
         
-        outsw(0x1F0, (uint16_t*)(buffer + i * 512), 256);
-        io_wait();
+        lba += chunk;
+        sector_count -= chunk;
+        buffer += chunk * 512;
     }
+    return 0;
+}
 
-    if (ata_wait_bsy()) {
-        outb(0x1F7, 0xE7);
-        ata_wait_bsy();
+static int ata_identify(uint16_t* data) {
+    outb(ATA_DRIVE_HEAD, 0xA0);
+    io_wait();
+    outb(ATA_SECTOR_CNT, 0);
+    outb(ATA_LBA_LOW, 0);
+    outb(ATA_LBA_MID, 0);
+    outb(ATA_LBA_HIGH, 0);
+    outb(ATA_COMMAND, ATA_CMD_IDENTIFY);
+    io_wait();
+    
+    // Estado 0 (o bus flotante) significa que no hay unidad
+    uint8_t status = inb(ATA_STATUS);
+    if (status == 0 || status == 0xFF) {
+        return 0;
+    }
+    
+    if (!ata_wait_bsy()) {
+        return 0;
+    }
+    
+    // Dispositivos ATAPI/SATA dejan una firma en LBA mid/high
+    if (inb(ATA_LBA_MID) != 0 || inb(ATA_LBA_HIGH) != 0) {
+        return 0;
+    }
+    
+    if (!ata_wait_drq()) {
+        return 0;
+    }
+    
+    insw(ATA_DATA, data, 256);
+    return 1;
+}
+
+static void ata_parse_identify(const uint16_t* data) {
+    ata.lba48 = (data[83] & (1 << 10)) != 0;
+    
+    if (ata.lba48) {
+        // Por encima de 2^32 sectores el LBA de 32 bits del resto del kernel no llega
+        if (data[102] || data[103]) {
+            ata.sectors = 0xFFFFFFFF;
+        } else {
+            ata.sectors = data[100] | ((uint32_t)data[101] << 16);
+        }
+    } else {
+        ata.sectors = data[60] | ((uint32_t)data[61] << 16);
+    }
+    
+    // El modelo viene como cadena con los bytes de cada palabra intercambiados
+    for (int i = 0; i < 20; i++) {
+        ata.model[i * 2] = data[27 + i] >> 8;
+        ata.model[i * 2 + 1] = data[27 + i] & 0xFF;
+    }
+    ata.model[40] = '\0';
+    for (int i = 39; i >= 0 && ata.model[i] == ' '; i--) {
+        ata.model[i] = '\0';
+    }
+}
+
+static void ata_set_multiple(const uint16_t* data) {
+    uint16_t max_multiple = data[47] & 0xFF;
+    
+    ata.multiple = 1;
+    if (max_multiple < 2) {
+        return;
+    }
+    
+    uint16_t multiple = max_multiple < ATA_MULTIPLE_MAX ? max_multiple : ATA_MULTIPLE_MAX;
+    
+    outb(ATA_DRIVE_HEAD, 0xE0);
+    io_wait();
+    outb(ATA_SECTOR_CNT, (uint8_t)multiple);
+    outb(ATA_COMMAND, ATA_CMD_SET_MULTIPLE);
+    io_wait();
+    
+    if (ata_wait_bsy() && !(inb(ATA_STATUS) & ATA_SR_ERR)) {
+        ata.multiple = multiple;
+    }
+}
+
+void disk_get_info(ata_info_t* info) {
+    memcpy(info, &ata, sizeof(ata_info_t));
+}
+
+static int ata_blockdev_read(blockdev_t* dev, uint32_t lba, uint32_t count, uint8_t* buffer) {
+    (void)dev;
+    return disk_read_sectors(lba, count, buffer);
+}
+
+static int ata_blockdev_write(blockdev_t* dev, uint32_t lba, uint32_t count, const uint8_t* buffer) {
+    (void)dev;
+    return disk_write_sectors(lba, count, buffer);
+}
+
+static const blockdev_ops_t ata_blockdev_ops = {
+    .read = ata_blockdev_read,
+    .write = ata_blockdev_write,
+};
+
+void disk_init(void) {
+    uint16_t identify[256];
+    
+    memset(&ata, 0, sizeof(ata_info_t));
+    
+    // Disco maestro del canal primario
+    if (!ata_identify(identify)) {
+        return;
     }
+    
+    ata.present = 1;
+    ata_parse_identify(identify);
+    ata_set_multiple(identify);
+    
+    kprintf("[ATA] %s, %s, %u sectors/DRQ\n", ata.model, ata.lba48 ? "LBA48" : "LBA28", ata.multiple);
+    
+    // disk_write_sectors ya vacía la caché en cada escritura
+    strcpy(ata_blockdev.name, "hda");
+    ata_blockdev.driver = "ata";
+    ata_blockdev.sector_count = ata.sectors;
+    ata_blockdev.read_only = 0;
+    ata_blockdev.ops = &ata_blockdev_ops;
+    ata_blockdev.priv = &ata;
+    
+    blockdev_register(&ata_blockdev);
 }
\ No newline at end of file
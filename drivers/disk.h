@@ -3,7 +3,49 @@
 
 #include "../kernel/kernel.h"
 
-void disk_read_sectors(uint32_t lba, uint8_t sector_count, uint8_t* buffer);
-void disk_write_sectors(uint32_t lba, uint8_t sector_count, uint8_t* buffer);
+// Registros del canal ATA primario
+#define ATA_DATA        0x1F0
+#define ATA_ERROR       0x1F1
+#define ATA_SECTOR_CNT  0x1F2
+#define ATA_LBA_LOW     0x1F3
+#define ATA_LBA_MID     0x1F4
+#define ATA_LBA_HIGH    0x1F5
+#define ATA_DRIVE_HEAD  0x1F6
+#define ATA_STATUS      0x1F7
+#define ATA_COMMAND     0x1F7
+
+#define ATA_SR_ERR  0x01
+#define ATA_SR_DRQ  0x08
+#define ATA_SR_DF   0x20
+#define ATA_SR_BSY  0x80
+
+#define ATA_CMD_READ_SECTORS      0x20
+#define ATA_CMD_READ_SECTORS_EXT  0x24
+#define ATA_CMD_READ_MULTIPLE_EXT 0x29
+#define ATA_CMD_WRITE_SECTORS     0x30
+#define ATA_CMD_WRITE_SECTORS_EXT 0x34
+#define ATA_CMD_WRITE_MULTIPLE_EXT 0x39
+#define ATA_CMD_READ_MULTIPLE     0xC4
+#define ATA_CMD_WRITE_MULTIPLE    0xC5
+#define ATA_CMD_SET_MULTIPLE      0xC6
+#define ATA_CMD_CACHE_FLUSH       0xE7
+#define ATA_CMD_CACHE_FLUSH_EXT   0xEA
+#define ATA_CMD_IDENTIFY          0xEC
+
+// Sectores por bloque DRQ que se piden con SET MULTIPLE MODE
+#define ATA_MULTIPLE_MAX 16
+
+typedef struct {
+    int present;
+    int lba48;
+    uint32_t sectors;
+    uint16_t multiple;
+    char model[41];
+} ata_info_t;
+
+void disk_init(void);
+void disk_get_info(ata_info_t* info);
+int disk_read_sectors(uint32_t lba, uint32_t sector_count, uint8_t* buffer);
+int disk_write_sectors(uint32_t lba, uint32_t sector_count, const uint8_t* buffer);
 
 #endif
@@ -0,0 +1,245 @@
+// drivers/e1000.c
+#include "e1000.h"
+#include "pci.h"
+#include "screen.h"
+#include "../kernel/memory.h"
+
+typedef struct {
+    volatile uint8_t* mmio;
+    uint32_t rx_cur;
+    uint32_t tx_cur;
+    uint32_t missed_packets;
+} e1000_t;
+
+static e1000_t e1000;
+static netdev_t e1000_netdev;
+
+// Los anillos deben estar alineados a 16 bytes y medir un múltiplo de 128
+static volatile e1000_rx_desc_t rx_ring[E1000_NUM_RX_DESC] __attribute__((aligned(128)));
+static volatile e1000_tx_desc_t tx_ring[E1000_NUM_TX_DESC] __attribute__((aligned(128)));
+// Buffers de paquetes fuera de la imagen del kernel, reservados en el probe
+static uint8_t (*rx_buffers)[E1000_BUFFER_SIZE];
+static uint8_t (*tx_buffers)[E1000_BUFFER_SIZE];
+
+static inline void e1000_write(e1000_t* nic, uint32_t reg, uint32_t value) {
+    *(volatile uint32_t*)(nic->mmio + reg) = value;
+}
+
+static inline uint32_t e1000_read(e1000_t* nic, uint32_t reg) {
+    return *(volatile uint32_t*)(nic->mmio + reg);
+}
+
+static uint16_t e1000_eeprom_read(e1000_t* nic, uint8_t addr) {
+    e1000_write(nic, E1000_EERD, 1 | ((uint32_t)addr << 8));
+    
+    for (int i = 0; i < 100000; i++) {
+        uint32_t value = e1000_read(nic, E1000_EERD);
+        if (value & (1 << 4)) {
+            return value >> 16;
+        }
+    }
+    return 0;
+}
+
+static void e1000_read_mac(e1000_t* nic, uint8_t* mac) {
+    uint32_t ral = e1000_read(nic, E1000_RAL0);
+    uint32_t rah = e1000_read(nic, E1000_RAH0);
+    
+    // RAH.AV indica que el registro ya contiene la dirección cargada de la EEPROM
+    if (rah & 0x80000000) {
+        for (int i = 0; i < 4; i++) {
+            mac[i] = (ral >> (i * 8)) & 0xFF;
+        }
+        mac[4] = rah & 0xFF;
+        mac[5] = (rah >> 8) & 0xFF;
+        return;
+    }
+    
+    for (int i = 0; i < 3; i++) {
+        uint16_t word = e1000_eeprom_read(nic, i);
+        mac[i * 2] = word & 0xFF;
+        mac[i * 2 + 1] = word >> 8;
+    }
+}
+
+static void e1000_init_rx(e1000_t* nic) {
+    for (int i = 0; i < E1000_NUM_RX_DESC; i++) {
+        rx_ring[i].addr = (uint32_t)rx_buffers[i];
+        rx_ring[i].status = 0;
+    }
+    
+    e1000_write(nic, E1000_RDBAL, (uint32_t)rx_ring);
+    e1000_write(nic, E1000_RDBAH, 0);
+    e1000_write(nic, E1000_RDLEN, sizeof(rx_ring));
+    e1000_write(nic, E1000_RDH, 0);
+    e1000_write(nic, E1000_RDT, E1000_NUM_RX_DESC - 1);
+    nic->rx_cur = 0;
+    
+    // Buffers de 2048 bytes (BSIZE = 00), broadcast y modo promiscuo como el RTL8139
+    e1000_write(nic, E1000_RCTL, E1000_RCTL_EN | E1000_RCTL_UPE | E1000_RCTL_MPE |
+                                 E1000_RCTL_BAM | E1000_RCTL_SECRC);
+}
+
+static void e1000_init_tx(e1000_t* nic) {
+    for (int i = 0; i < E1000_NUM_TX_DESC; i++) {
+        tx_ring[i].addr = (uint32_t)tx_buffers[i];
+        tx_ring[i].cmd = 0;
+        tx_ring[i].status = E1000_TXD_STAT_DD;
+    }
+    
+    e1000_write(nic, E1000_TDBAL, (uint32_t)tx_ring);
+    e1000_write(nic, E1000_TDBAH, 0);
+    e1000_write(nic, E1000_TDLEN, sizeof(tx_ring));
+    e1000_write(nic, E1000_TDH, 0);
+    e1000_write(nic, E1000_TDT, 0);
+    nic->tx_cur = 0;
+    
+    e1000_write(nic, E1000_TCTL, E1000_TCTL_EN | E1000_TCTL_PSP |
+                                 (0x10 << E1000_TCTL_CT_SHIFT) |
+                                 (0x40 << E1000_TCTL_COLD_SHIFT));
+    e1000_write(nic, E1000_TIPG, 0x0060200A);
+}
+
+static int e1000_send(netdev_t* dev, const uint8_t* data, uint16_t length) {
+    e1000_t* nic = (e1000_t*)dev->priv;
+    
+    if (length > E1000_BUFFER_SIZE) {
+        return -1;
+    }
+    
+    // El descriptor se libera cuando el hardware marca DD; no se espera a la transmisión
+    volatile e1000_tx_desc_t* desc = &tx_ring[nic->tx_cur];
+    for (int i = 0; !(desc->status & E1000_TXD_STAT_DD); i++) {
+        if (i > 1000000) {
+            return -1;
+        }
+    }
+    
+    memcpy(tx_buffers[nic->tx_cur], data, length);
+    
+    if (length < 60) {
+        memset(tx_buffers[nic->tx_cur] + length, 0, 60 - length);
+        length = 60;
+    }
+    
+    desc->length = length;
+    desc->status = 0;
+    desc->cmd = E1000_TXD_CMD_EOP | E1000_TXD_CMD_IFCS | E1000_TXD_CMD_RS;
+    
+    nic->tx_cur = (nic->tx_cur + 1) % E1000_NUM_TX_DESC;
+    e1000_write(nic, E1000_TDT, nic->tx_cur);
+    
+    return 0;
+}
+
+static int e1000_poll(netdev_t* dev, uint8_t* buffer, uint16_t max_length) {
+    e1000_t* nic = (e1000_t*)dev->priv;
+    volatile e1000_rx_desc_t* desc = &rx_ring[nic->rx_cur];
+    
+    if (!(desc->status & E1000_RXD_STAT_DD)) {
+        return 0;
+    }
+    
+    int length = desc->length;
+    
+    // Tramas repartidas en varios descriptores o con errores se descartan
+    if (!(desc->status & E1000_RXD_STAT_EOP) || desc->errors) {
+        dev->stats.rx_dropped++;
+        length = 0;
+    } else {
+        if (length > max_length) {
+            length = max_length;
+        }
+        memcpy(buffer, rx_buffers[nic->rx_cur], length);
+    }
+    
+    // Devolver el descriptor al hardware
+    desc->status = 0;
+    e1000_write(nic, E1000_RDT, nic->rx_cur);
+    nic->rx_cur = (nic->rx_cur + 1) % E1000_NUM_RX_DESC;
+    
+    return length;
+}
+
+static void e1000_get_stats(netdev_t* dev, netdev_stats_t* stats) {
+    e1000_t* nic = (e1000_t*)dev->priv;
+    
+    // Los contadores estadísticos del e1000 se borran al leerlos
+    nic->missed_packets += e1000_read(nic, E1000_MPC);
+    stats->rx_dropped += nic->missed_packets;
+}
+
+static const netdev_ops_t e1000_ops = {
+    .send = e1000_send,
+    .poll = e1000_poll,
+    .get_stats = e1000_get_stats,
+};
+
+// Devuelve -1 si el controlador no sale del reset
+static int e1000_init(e1000_t* nic, uint32_t bar0) {
+    nic->mmio = (volatile uint8_t*)(bar0 & ~0xF);
+    nic->missed_packets = 0;
+    
+    // Reset del controlador
+    e1000_write(nic, E1000_IMC, 0xFFFFFFFF);
+    e1000_write(nic, E1000_CTRL, e1000_read(nic, E1000_CTRL) | E1000_CTRL_RST);
+    for (volatile int i = 0; i < 100000; i++);
+    for (int i = 0; e1000_read(nic, E1000_CTRL) & E1000_CTRL_RST; i++) {
+        if (i > 1000000) {
+            return -1;
+        }
+    }
+    
+    // Sin interrupciones: la pila de red trabaja por sondeo
+    e1000_write(nic, E1000_IMC, 0xFFFFFFFF);
+    e1000_read(nic, E1000_ICR);
+    
+    e1000_write(nic, E1000_CTRL, e1000_read(nic, E1000_CTRL) | E1000_CTRL_SLU | E1000_CTRL_ASDE);
+    
+    e1000_read_mac(nic, e1000_netdev.mac);
+    
+    for (int i = 0; i < 128; i++) {
+        e1000_write(nic, E1000_MTA + i * 4, 0);
+    }
+    
+    e1000_init_rx(nic);
+    e1000_init_tx(nic);
+    return 0;
+}
+
+int e1000_probe(void) {
+    pci_device_t pci;
+    
+    if (!pci_find_device(PCI_VENDOR_INTEL, PCI_DEVICE_INTEL_E1000, &pci) &&
+        !pci_find_device(PCI_VENDOR_INTEL, PCI_DEVICE_INTEL_E1000E, &pci)) {
+        return 0;
+    }
+    
+    screen_print("[NET] Found Intel e1000 NIC\n");
+    
+    if (!rx_buffers) {
+        rx_buffers = kmem_alloc(E1000_NUM_RX_DESC * E1000_BUFFER_SIZE);
+        tx_buffers = kmem_alloc(E1000_NUM_TX_DESC * E1000_BUFFER_SIZE);
+        if (!rx_buffers || !tx_buffers) {
+            rx_buffers = 0;
+            screen_print("[NET] e1000: out of memory\n");
+            return 0;
+        }
+    }
+
+    // Habilitar bus mastering y espacio de memoria
+    uint16_t command = pci_read_config(pci.bus, pci.device, pci.function, PCI_COMMAND) & 0xFFFF;
+    command |= PCI_COMMAND_MEMORY | PCI_COMMAND_MASTER;
+    pci_write_config(pci.bus, pci.device, pci.function, PCI_COMMAND, command);
+    
+    if (e1000_init(&e1000, pci.bar0) != 0) {
+        screen_print("[NET] e1000: reset timed out\n");
+        return 0;
+    }
+    
+    e1000_netdev.driver = "e1000";
+    e1000_netdev.ops = &e1000_ops;
+    e1000_netdev.priv = &e1000;
+    
+    return netdev_register(&e1000_netdev) == 0;
+}
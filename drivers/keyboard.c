@@ -1,6 +1,19 @@
 // drivers/keyboard.c
 #include "keyboard.h"
 #include "screen.h"
+#include "../kernel/idt.h"
+#include "../kernel/ring.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/thread.h"
+
+#define KBD_DATA   0x60
+#define KBD_STATUS 0x64
+
+#define SC_LSHIFT 0x2A
+#define SC_RSHIFT 0x36
+#define SC_CTRL   0x1D
+#define SC_ALT    0x38
+#define SC_CAPS   0x3A
 
 static const char scancode_to_ascii[] = {
     0, 0, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b',
@@ -18,11 +31,20 @@ static const char scancode_to_ascii_shift[] = {
     '*', 0, ' '
 };
 
-static int shift_pressed = 0;
+// Productor: el manejador de IRQ1. Consumidor: quien lee del teclado
+static void* key_slots[KEYBOARD_RING_SIZE];
+static spsc_ring_t key_ring;
 
-void keyboard_init(void) {
-    shift_pressed = 0;
-}
+// Lectores dormidos a la espera de una tecla; key_lock ordena comprobación y despertar
+static wait_queue_t key_waiters;
+static spinlock_t key_lock;
+
+// Estado que solo toca el manejador de interrupción
+static int shift_count = 0;
+static int ctrl_down = 0;
+static int alt_down = 0;
+static int caps_lock = 0;
+static int extended = 0;
 
 static uint8_t inb(uint16_t port) {
     uint8_t ret;
@@ -30,41 +52,179 @@ static uint8_t inb(uint16_t port) {
     return ret;
 }
 
-uint8_t keyboard_get_scancode(void) {
-    while (1) {
-        uint8_t status = inb(0x64);
-        if (status & 0x01) {
-            return inb(0x60);
+static char keyboard_translate(uint8_t scancode, uint8_t mods) {
+    if (scancode >= sizeof(scancode_to_ascii)) {
+        return 0;
+    }
+    
+    char c = scancode_to_ascii[scancode];
+    int shifted = (mods & KEY_MOD_SHIFT) != 0;
+    
+    // Bloq Mayús solo invierte las letras
+    if (c >= 'a' && c <= 'z' && (mods & KEY_MOD_CAPS)) {
+        shifted = !shifted;
+    }
+    if (shifted) {
+        c = scancode_to_ascii_shift[scancode];
+    }
+    
+    // Ctrl+letra da el carácter de control correspondiente (Ctrl+C = 3)
+    if ((mods & KEY_MOD_CTRL) && ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))) {
+        c &= 0x1F;
+    }
+    
+    return c;
+}
+
+static void keyboard_handler(interrupt_frame_t* frame) {
+    (void)frame;
+    
+    uint8_t scancode = inb(KBD_DATA);
+    
+    if (scancode == 0xE0) {
+        extended = 1;
+        return;
+    }
+    
+    uint8_t released = scancode & 0x80;
+    uint8_t code = scancode & 0x7F;
+    int was_extended = extended;
+    extended = 0;
+    
+    // Mayúsculas falsas que el teclado intercala con las teclas extendidas
+    if (was_extended && (code == SC_LSHIFT || code == SC_RSHIFT)) {
+        return;
+    }
+    
+    if (code == SC_LSHIFT || code == SC_RSHIFT) {
+        shift_count += released ? -1 : 1;
+        if (shift_count < 0) shift_count = 0;
+    } else if (code == SC_CTRL) {
+        ctrl_down = !released;
+    } else if (code == SC_ALT) {
+        alt_down = !released;
+    } else if (code == SC_CAPS && !released) {
+        caps_lock = !caps_lock;
+    }
+    
+    uint8_t flags = 0;
+    if (shift_count) flags |= KEY_MOD_SHIFT;
+    if (ctrl_down) flags |= KEY_MOD_CTRL;
+    if (alt_down) flags |= KEY_MOD_ALT;
+    if (caps_lock) flags |= KEY_MOD_CAPS;
+    if (was_extended) flags |= KEY_FLAG_EXTENDED;
+    if (released) flags |= KEY_FLAG_RELEASED;
+    
+    // Las teclas extendidas (cursores, bloque de edición) no generan carácter,
+    // salvo Intro y '/' del teclado numérico
+    char ascii = 0;
+    if (!released && (!was_extended || code == KEY_ENTER || code == 0x35)) {
+        ascii = keyboard_translate(code, flags);
+    }
+    
+    uint32_t packed = code | ((uint32_t)flags << 8) | ((uint32_t)(uint8_t)ascii << 16);
+    
+    // Con el anillo lleno se descarta la tecla más nueva
+    spsc_ring_push(&key_ring, (void*)packed);
+    
+    spin_lock(&key_lock);
+    wait_queue_wake_one(&key_waiters);
+    spin_unlock(&key_lock);
+}
+
+void keyboard_init(void) {
+    irq_mask(IRQ_KEYBOARD);
+    
+    spsc_ring_init(&key_ring, key_slots, KEYBOARD_RING_SIZE);
+    wait_queue_init(&key_waiters);
+    spin_lock_init(&key_lock, "keyboard");
+    shift_count = 0;
+    ctrl_down = 0;
+    alt_down = 0;
+    caps_lock = 0;
+    extended = 0;
+    
+    // Descartar lo que hubiera en el controlador antes de activar la IRQ
+    for (int i = 0; i < 16 && (inb(KBD_STATUS) & 0x01); i++) {
+        inb(KBD_DATA);
+    }
+    
+    irq_register_handler(IRQ_KEYBOARD, keyboard_handler);
+    irq_unmask(IRQ_KEYBOARD);
+}
+
+static void keyboard_unpack(void* item, key_event_t* event) {
+    uint32_t packed = (uint32_t)item;
+    event->scancode = packed & 0xFF;
+    event->flags = (packed >> 8) & 0xFF;
+    event->ascii = (char)((packed >> 16) & 0xFF);
+}
+
+int keyboard_poll_event(key_event_t* event) {
+    void* item;
+    if (spsc_ring_pop(&key_ring, &item) != 0) {
+        return 0;
+    }
+    keyboard_unpack(item, event);
+    return 1;
+}
+
+// El lector se encola antes de soltar key_lock, así que la IRQ no puede despertar antes de tiempo
+void keyboard_get_event(key_event_t* event) {
+    while (!keyboard_poll_event(event)) {
+        uint32_t flags = spin_lock_irqsave(&key_lock);
+        if (spsc_ring_count(&key_ring) == 0) {
+            wait_queue_sleep_unlock(&key_waiters, &key_lock);
+            spin_lock(&key_lock);
         }
+        spin_unlock_irqrestore(&key_lock, flags);
     }
 }
 
-char keyboard_getchar(void) {
-    while (1) {
-        uint8_t status = inb(0x64);
-        if (status & 0x01) {
-            uint8_t scancode = inb(0x60);
+void keyboard_flush(void) {
+    key_event_t event;
+    while (keyboard_poll_event(&event));
+}
 
-            if (scancode == 0x2A || scancode == 0x36) {
-                shift_pressed = 1;
-                continue;
-            }
+uint8_t keyboard_get_scancode(void) {
+    key_event_t event;
+    keyboard_get_event(&event);
+    return event.scancode | (event.flags & KEY_FLAG_RELEASED);
+}
 
-            if (scancode == 0xAA || scancode == 0xB6) {
-                shift_pressed = 0;
+// Siguiente pulsación; las liberaciones y el desplazamiento de la consola se atienden aquí
+void keyboard_read_key(key_event_t* out) {
+    while (1) {
+        key_event_t event;
+        keyboard_get_event(&event);
+        
+        if (event.flags & KEY_FLAG_RELEASED) {
+            continue;
+        }
+        
+        // Shift+RePág/AvPág recorren el historial de la consola
+        if ((event.flags & KEY_FLAG_EXTENDED) && (event.flags & KEY_MOD_SHIFT)) {
+            if (event.scancode == KEY_PAGE_UP) {
+                screen_page_up();
                 continue;
             }
-
-            if (scancode & 0x80) {
+            if (event.scancode == KEY_PAGE_DOWN) {
+                screen_page_down();
                 continue;
             }
+        }
+        
+        *out = event;
+        return;
+    }
+}
 
-            if (scancode < sizeof(scancode_to_ascii)) {
-                char c = shift_pressed ? scancode_to_ascii_shift[scancode] : scancode_to_ascii[scancode];
-                if (c) {
-                    return c;
-                }
-            }
+char keyboard_getchar(void) {
+    while (1) {
+        key_event_t event;
+        keyboard_read_key(&event);
+        if (event.ascii) {
+            return event.ascii;
         }
     }
 }
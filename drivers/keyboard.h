@@ -6,8 +6,36 @@
 
 #define KEY_UP 0x48
 #define KEY_DOWN 0x50
+#define KEY_LEFT 0x4B
+#define KEY_RIGHT 0x4D
+#define KEY_HOME 0x47
+#define KEY_END 0x4F
+#define KEY_DELETE 0x53
+#define KEY_PAGE_UP 0x49
+#define KEY_PAGE_DOWN 0x51
+#define KEY_ENTER 0x1C
+
+// Estado de los modificadores en el momento de la tecla
+#define KEY_MOD_SHIFT    0x01
+#define KEY_MOD_CTRL     0x02
+#define KEY_MOD_ALT      0x04
+#define KEY_MOD_CAPS     0x08
+#define KEY_FLAG_EXTENDED 0x40  // precedida de 0xE0
+#define KEY_FLAG_RELEASED 0x80
+
+#define KEYBOARD_RING_SIZE 128  // potencia de dos
+
+typedef struct {
+    uint8_t scancode;   // sin el bit de liberación
+    uint8_t flags;      // KEY_MOD_* | KEY_FLAG_*
+    char ascii;         // 0 si la tecla no produce carácter
+} key_event_t;
 
 void keyboard_init(void);
+void keyboard_get_event(key_event_t* event);
+int keyboard_poll_event(key_event_t* event);
+void keyboard_flush(void);
+void keyboard_read_key(key_event_t* event);
 char keyboard_getchar(void);
 void keyboard_getline(char* buffer, int max_length);
 uint8_t keyboard_get_scancode(void);
@@ -3,11 +3,15 @@
 #define NETWORK_H
 
 #include "../kernel/kernel.h"
+#include "../kernel/spinlock.h"
 
 #define ETH_ALEN 6
 #define ETH_FRAME_LEN 1518
 #define ETH_DATA_LEN 1500
 
+#define NETDEV_MAX 4
+#define NETDEV_NAME_LEN 8
+
 typedef struct {
     uint8_t mac[ETH_ALEN];
     uint32_t ip;
@@ -15,12 +19,53 @@ typedef struct {
     int dhcp_configured;
 } network_info_t;
 
-// Funciones principales
+typedef struct {
+    uint32_t rx_packets;
+    uint32_t rx_bytes;
+    uint32_t rx_dropped;
+    uint32_t tx_packets;
+    uint32_t tx_bytes;
+    uint32_t tx_errors;
+} netdev_stats_t;
+
+typedef struct netdev netdev_t;
+
+// Operaciones que implementa cada driver de red
+typedef struct {
+    int (*send)(netdev_t* dev, const uint8_t* data, uint16_t length);
+    int (*poll)(netdev_t* dev, uint8_t* buffer, uint16_t max_length);
+    void (*get_stats)(netdev_t* dev, netdev_stats_t* stats);
+    void (*flush)(netdev_t* dev);
+} netdev_ops_t;
+
+struct netdev {
+    char name[NETDEV_NAME_LEN];
+    const char* driver;
+    uint8_t mac[ETH_ALEN];
+    const netdev_ops_t* ops;
+    void* priv;
+    netdev_stats_t stats;
+    // Serializa el acceso a los anillos y registros de la NIC entre procesadores
+    spinlock_t lock;
+};
+
+// Registro de interfaces
+int netdev_register(netdev_t* dev);
+int netdev_count(void);
+netdev_t* netdev_get(int index);
+netdev_t* netdev_default(void);
+int netdev_send(netdev_t* dev, const uint8_t* data, uint16_t length);
+int netdev_poll(netdev_t* dev, uint8_t* buffer, uint16_t max_length);
+void netdev_get_stats(netdev_t* dev, netdev_stats_t* stats);
+void netdev_flush(netdev_t* dev);
+
+// Funciones principales (operan sobre la interfaz por defecto)
 void network_init(void);
 int network_is_ready(void);
 void network_get_info(network_info_t* info);
 void network_send_packet(const uint8_t* data, uint16_t length);
 int network_receive_packet(uint8_t* buffer, uint16_t max_length);
+void network_flush(void);
 
 // Funciones de utilidad
 void network_set_mac(const uint8_t* mac);
@@ -28,4 +73,4 @@ void network_get_mac(uint8_t* mac);
 void network_set_ip(uint32_t ip);
 uint32_t network_get_ip(void);
 
-#endif
\ No newline at end of file
+#endif
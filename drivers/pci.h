@@ -23,17 +23,25 @@
 #define PCI_BAR5 0x24
 #define PCI_INTERRUPT_LINE 0x3C
 
+// Bits del registro de comando
+#define PCI_COMMAND_IO 0x01
+#define PCI_COMMAND_MEMORY 0x02
+#define PCI_COMMAND_MASTER 0x04
+
 // Network controller class
 #define PCI_CLASS_NETWORK 0x02
 
 // Vendor IDs
 #define PCI_VENDOR_INTEL 0x8086
 #define PCI_VENDOR_REALTEK 0x10EC
+#define PCI_VENDOR_VIRTIO 0x1AF4
 
 // Device IDs
 #define PCI_DEVICE_INTEL_E1000 0x100E
 #define PCI_DEVICE_INTEL_E1000E 0x10D3
 #define PCI_DEVICE_RTL8139 0x8139
+#define PCI_DEVICE_VIRTIO_NET 0x1000
+#define PCI_DEVICE_VIRTIO_BLK 0x1001
 
 typedef struct {
     uint16_t vendor_id;
@@ -0,0 +1,234 @@
+// drivers/rtl8139.c
+#include "rtl8139.h"
+#include "pci.h"
+#include "screen.h"
+
+// RTL8139 Registers
+#define RTL8139_IDR0        0x00
+#define RTL8139_MAR0        0x08
+#define RTL8139_TSD0        0x10
+#define RTL8139_TSAD0       0x20
+#define RTL8139_RBSTART     0x30
+#define RTL8139_CMD         0x37
+#define RTL8139_CAPR        0x38
+#define RTL8139_CBR         0x3A
+#define RTL8139_IMR         0x3C
+#define RTL8139_ISR         0x3E
+#define RTL8139_TCR         0x40
+#define RTL8139_RCR         0x44
+#define RTL8139_MPC         0x4C
+#define RTL8139_CONFIG1     0x52
+
+// RTL8139 Commands
+#define RTL8139_CMD_RESET   0x10
+#define RTL8139_CMD_RX_EN   0x08
+#define RTL8139_CMD_TX_EN   0x04
+
+// Buffer sizes
+#define RX_BUFFER_SIZE (8192 + 16 + 1500)
+#define TX_BUFFER_SIZE 2048
+
+typedef struct {
+    uint32_t io_base;
+    uint16_t rx_offset;
+    int tx_port;
+    uint32_t missed_packets;
+} rtl8139_t;
+
+static rtl8139_t rtl;
+static netdev_t rtl_netdev;
+
+static uint8_t rx_buffer[RX_BUFFER_SIZE] __attribute__((aligned(4)));
+static uint8_t tx_buffer[TX_BUFFER_SIZE] __attribute__((aligned(4)));
+
+static inline void outb(uint16_t port, uint8_t value) {
+    asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint8_t inb(uint16_t port) {
+    uint8_t ret;
+    asm volatile("inb %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+static inline void outl(uint16_t port, uint32_t value) {
+    asm volatile("outl %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint32_t inl(uint16_t port) {
+    uint32_t ret;
+    asm volatile("inl %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+static inline void outw(uint16_t port, uint16_t value) {
+    asm volatile("outw %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static void rtl8139_reset(rtl8139_t* nic) {
+    outb(nic->io_base + RTL8139_CMD, RTL8139_CMD_RESET);
+    
+    while ((inb(nic->io_base + RTL8139_CMD) & RTL8139_CMD_RESET) != 0) {
+        for (volatile int i = 0; i < 1000; i++);
+    }
+}
+
+static int rtl8139_send(netdev_t* dev, const uint8_t* data, uint16_t length) {
+    rtl8139_t* nic = (rtl8139_t*)dev->priv;
+    
+    if (length > TX_BUFFER_SIZE) {
+        return -1;
+    }
+    
+    // Copiar datos al buffer de TX
+    memcpy(tx_buffer, data, length);
+    
+    // Asegurar tamaño mínimo de 60 bytes
+    if (length < 60) {
+        memset(tx_buffer + length, 0, 60 - length);
+        length = 60;
+    }
+    
+    uint32_t tx_status_port = RTL8139_TSD0 + (nic->tx_port * 4);
+    uint32_t tx_addr_port = RTL8139_TSAD0 + (nic->tx_port * 4);
+    
+    // Escribir dirección del buffer
+    outl(nic->io_base + tx_addr_port, (uint32_t)tx_buffer);
+    
+    // Escribir longitud y comenzar transmisión
+    outl(nic->io_base + tx_status_port, length & 0x1FFF);
+    
+    // Esperar a que termine la transmisión
+    while (!(inl(nic->io_base + tx_status_port) & 0x8000)) {
+        for (volatile int i = 0; i < 100; i++);
+    }
+    
+    nic->tx_port = (nic->tx_port + 1) % 4;
+    return 0;
+}
+
+static int rtl8139_poll(netdev_t* dev, uint8_t* buffer, uint16_t max_length) {
+    rtl8139_t* nic = (rtl8139_t*)dev->priv;
+    
+    // Verificar si hay datos disponibles
+    uint8_t cmd = inb(nic->io_base + RTL8139_CMD);
+    if (cmd & 0x01) { // Buffer vacío
+        return 0;
+    }
+    
+    // Leer el header del paquete
+    uint16_t* header = (uint16_t*)(&rx_buffer[nic->rx_offset]);
+    uint16_t status = header[0];
+    uint16_t length = header[1];
+    
+    // Verificar status
+    if (!(status & 0x01)) { // Paquete no válido
+        // Reset del RX
+        outb(nic->io_base + RTL8139_CMD, 0x0C); // Solo TX habilitado
+        for (volatile int i = 0; i < 10000; i++);
+        nic->rx_offset = 0;
+        outl(nic->io_base + RTL8139_RBSTART, (uint32_t)rx_buffer);
+        outb(nic->io_base + RTL8139_CMD, RTL8139_CMD_RX_EN | RTL8139_CMD_TX_EN);
+        dev->stats.rx_dropped++;
+        return -1;
+    }
+    
+    // Verificar longitud
+    if (length < 60 || length > 1518) {
+        // Saltar paquete malo
+        nic->rx_offset = (nic->rx_offset + length + 4 + 3) & ~3;
+        if (nic->rx_offset >= 8192) nic->rx_offset -= 8192;
+        outw(nic->io_base + RTL8139_CAPR, nic->rx_offset - 0x10);
+        dev->stats.rx_dropped++;
+        return 0;
+    }
+    
+    // Quitar CRC (4 bytes)
+    length -= 4;
+    
+    // Limitar al tamaño del buffer
+    if (length > max_length) {
+        length = max_length;
+    }
+    
+    // Copiar datos
+    memcpy(buffer, &rx_buffer[nic->rx_offset + 4], length);
+    
+    // Actualizar offset
+    nic->rx_offset = (nic->rx_offset + length + 4 + 3) & ~3;
+    if (nic->rx_offset >= 8192) nic->rx_offset -= 8192;
+    
+    // Actualizar CAPR
+    outw(nic->io_base + RTL8139_CAPR, nic->rx_offset - 0x10);
+    
+    return length;
+}
+
+static void rtl8139_get_stats(netdev_t* dev, netdev_stats_t* stats) {
+    rtl8139_t* nic = (rtl8139_t*)dev->priv;
+    
+    // MPC cuenta paquetes perdidos por falta de espacio en el buffer; se borra al escribirlo
+    nic->missed_packets += inl(nic->io_base + RTL8139_MPC) & 0xFFFFFF;
+    outl(nic->io_base + RTL8139_MPC, 0);
+    stats->rx_dropped += nic->missed_packets;
+}
+
+static const netdev_ops_t rtl8139_ops = {
+    .send = rtl8139_send,
+    .poll = rtl8139_poll,
+    .get_stats = rtl8139_get_stats,
+};
+
+static void rtl8139_init(rtl8139_t* nic, uint32_t bar0) {
+    nic->io_base = bar0 & ~0x3;
+    nic->rx_offset = 0;
+    nic->tx_port = 0;
+    nic->missed_packets = 0;
+    
+    // Reset
+    rtl8139_reset(nic);
+    
+    // Leer MAC
+    for (int i = 0; i < ETH_ALEN; i++) {
+        rtl_netdev.mac[i] = inb(nic->io_base + RTL8139_IDR0 + i);
+    }
+    
+    // Configurar buffer de recepción
+    outl(nic->io_base + RTL8139_RBSTART, (uint32_t)rx_buffer);
+    
+    // Habilitar todas las interrupciones
+    outw(nic->io_base + RTL8139_IMR, 0x0005);
+    
+    // Configurar recepción: aceptar broadcast, multicast y paquetes físicos
+    // WRAP, AB (Accept Broadcast), AM (Accept Multicast), APM (Accept Physical Match), AAP (Accept All Packets)
+    outl(nic->io_base + RTL8139_RCR, 0x0000070F);
+    
+    // Configurar transmisión
+    outl(nic->io_base + RTL8139_TCR, 0x03000000);
+    
+    // Habilitar RX y TX
+    outb(nic->io_base + RTL8139_CMD, RTL8139_CMD_RX_EN | RTL8139_CMD_TX_EN);
+}
+
+int rtl8139_probe(void) {
+    pci_device_t pci;
+    
+    if (!pci_find_device(PCI_VENDOR_REALTEK, PCI_DEVICE_RTL8139, &pci)) {
+        return 0;
+    }
+    
+    screen_print("[NET] Found RTL8139 NIC\n");
+    
+    // Habilitar bus mastering e IO space
+    uint16_t command = pci_read_config(pci.bus, pci.device, pci.function, PCI_COMMAND) & 0xFFFF;
+    command |= PCI_COMMAND_IO | PCI_COMMAND_MASTER;
+    pci_write_config(pci.bus, pci.device, pci.function, PCI_COMMAND, command);
+    
+    rtl8139_init(&rtl, pci.bar0);
+    
+    rtl_netdev.driver = "rtl8139";
+    rtl_netdev.ops = &rtl8139_ops;
+    rtl_netdev.priv = &rtl;
+    
+    return netdev_register(&rtl_netdev) == 0;
+}
@@ -0,0 +1,9 @@
+// drivers/rtl8139.h
+#ifndef RTL8139_H
+#define RTL8139_H
+
+#include "network.h"
+
+int rtl8139_probe(void);
+
+#endif
@@ -1,21 +1,121 @@
 // drivers/screen.c
 #include "screen.h"
+#include "../kernel/spinlock.h"
 
 static int cursor_x = 0;
 static int cursor_y = 0;
 static uint8_t current_foreground = 0x0F;
 static uint8_t current_background = 0x00;
 
-#define SCREEN_WIDTH 80
-#define SCREEN_HEIGHT 25
+#define TEXT_WIDTH 80
+#define TEXT_HEIGHT 25
 #define VIDEO_MEMORY 0xB8000
+#define GLYPH_WIDTH 8
+
+// Tamaño en celdas: 80x25 en modo texto, lo que quepa del framebuffer si no
+static int screen_cols = TEXT_WIDTH;
+static int screen_rows = TEXT_HEIGHT;
+static int screen_cells = TEXT_WIDTH * TEXT_HEIGHT;
+
+// Anillo de líneas: la pantalla en vivo son las screen_rows que empiezan en top_line
+// y las anteriores forman el historial. Solo el rango modificado pasa a la pantalla
+static uint16_t ring[SCREEN_SCROLLBACK_LINES][SCREEN_MAX_COLS] __attribute__((aligned(4)));
+static int top_line = 0;
+static int history_lines = 0;
+static int view_offset = 0;
+static int dirty_start = 0;
+static int dirty_end = 0;
+static int hw_cursor = -1;
+static int initialized = 0;
+static spinlock_t screen_lock;
+
+// Destinos adicionales de la salida de la consola (p. ej. el puerto serie)
+static screen_sink_t sinks[SCREEN_MAX_SINKS];
+static int sink_count = 0;
+static screen_redirect_t redirect = 0;
+
+// Consola gráfica: cada byte de una fila del glifo ya está expandido a 8 máscaras
+// de 32 bits, así una celda son 16 tramos de 8 escrituras sin bifurcaciones
+static int fb_active = 0;
+static uint8_t* fb_base = 0;
+static uint32_t fb_pitch = 0;
+static uint32_t fb_size = 0;
+static int font_height = 16;
+static const uint8_t* font = 0;
+static uint32_t glyph_masks[256][GLYPH_WIDTH];
+static uint16_t displayed[SCREEN_MAX_COLS * SCREEN_MAX_ROWS];
+// Líneas avanzadas desde el último volcado; el framebuffer las desplaza de una vez
+static int pending_scroll = 0;
+
+static const uint32_t palette[16] = {
+    0x000000, 0x0000AA, 0x00AA00, 0x00AAAA, 0xAA0000, 0xAA00AA, 0xAA5500, 0xAAAAAA,
+    0x555555, 0x5555FF, 0x55FF55, 0x55FFFF, 0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF
+};
 
 static void outb(uint16_t port, uint8_t value) {
     asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
 }
 
+// Fila de pantalla desplazada 'back' líneas hacia el historial
+static uint16_t* ring_row(int row, int back) {
+    int index = top_line + row - back;
+    while (index < 0) index += SCREEN_SCROLLBACK_LINES;
+    while (index >= SCREEN_SCROLLBACK_LINES) index -= SCREEN_SCROLLBACK_LINES;
+    return ring[index];
+}
+
+static void fb_draw_cell(int pos, uint16_t cell) {
+    int row = pos / screen_cols;
+    int col = pos % screen_cols;
+    uint32_t fg = palette[(cell >> 8) & 0x0F];
+    uint32_t bg = palette[(cell >> 12) & 0x0F];
+    const uint8_t* glyph = font + (cell & 0xFF) * font_height;
+    uint8_t* line = fb_base + row * font_height * fb_pitch + col * GLYPH_WIDTH * 4;
+    
+    for (int y = 0; y < font_height; y++) {
+        const uint32_t* mask = glyph_masks[glyph[y]];
+        volatile uint32_t* px = (volatile uint32_t*)line;
+        for (int x = 0; x < GLYPH_WIDTH; x++) {
+            px[x] = (fg & mask[x]) | (bg & ~mask[x]);
+        }
+        line += fb_pitch;
+    }
+}
+
+// El cursor gráfico es un subrayado de dos líneas en el color del carácter
+static void fb_draw_cursor(int pos) {
+    int row = pos / screen_cols;
+    int col = pos % screen_cols;
+    uint32_t fg = palette[(displayed[pos] >> 8) & 0x0F];
+    uint8_t* line = fb_base + (row * font_height + font_height - 2) * fb_pitch + col * GLYPH_WIDTH * 4;
+    
+    for (int y = 0; y < 2; y++) {
+        volatile uint32_t* px = (volatile uint32_t*)line;
+        for (int x = 0; x < GLYPH_WIDTH; x++) {
+            px[x] = fg;
+        }
+        line += fb_pitch;
+    }
+}
+
 static void update_cursor(void) {
-    int pos = cursor_y * SCREEN_WIDTH + cursor_x;
+    // Fuera de pantalla (oculto) mientras se mira el historial
+    int pos = view_offset ? screen_cells : cursor_y * screen_cols + cursor_x;
+    if (pos == hw_cursor) {
+        return;
+    }
+    
+    if (fb_active) {
+        if (hw_cursor >= 0 && hw_cursor < screen_cells) {
+            fb_draw_cell(hw_cursor, displayed[hw_cursor]);
+        }
+        if (pos < screen_cells) {
+            fb_draw_cursor(pos);
+        }
+        hw_cursor = pos;
+        return;
+    }
+    hw_cursor = pos;
     
     uint8_t high = (pos >> 8) & 0xFF;
     uint8_t low = pos & 0xFF;
@@ -27,67 +127,144 @@ static void update_cursor(void) {
     outb(0x3D5, low);
 }
 
-static void scroll_down(void) {
-    uint16_t* video = (uint16_t*)VIDEO_MEMORY;
-    
-    for (int i = 0; i < SCREEN_WIDTH * (SCREEN_HEIGHT - 1); i++) {
-        video[i] = video[i + SCREEN_WIDTH];
+static void sinks_write(const char* data, uint32_t length) {
+    for (int i = 0; i < sink_count; i++) {
+        sinks[i](data, length);
     }
+}
+
+static inline uint16_t blank_cell(void) {
+    return (current_background << 12) | (current_foreground << 8) | ' ';
+}
+
+static inline void mark_dirty(int start, int end) {
+    if (start < dirty_start) dirty_start = start;
+    if (end > dirty_end) dirty_end = end;
+}
+
+static void put_cell(int pos, uint16_t value) {
+    ring_row(pos / screen_cols, 0)[pos % screen_cols] = value;
+    mark_dirty(pos, pos + 1);
+}
+
+// Texto: copia a la VGA en palabras de 32 bits, la mitad de accesos que celda a celda
+static void text_flush(int first_row, int last_row) {
+    volatile uint32_t* video = (volatile uint32_t*)VIDEO_MEMORY;
     
-    uint16_t space = (current_background << 12) | (current_foreground << 8) | ' ';
-    for (int i = SCREEN_WIDTH * (SCREEN_HEIGHT - 1); i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
-        video[i] = space;
+    for (int row = first_row; row <= last_row; row++) {
+        int start = row == first_row ? dirty_start % screen_cols : 0;
+        int end = row == last_row ? (dirty_end - 1) % screen_cols + 1 : screen_cols;
+        const uint32_t* src = (const uint32_t*)ring_row(row, view_offset);
+        volatile uint32_t* dst = video + row * (TEXT_WIDTH / 2);
+        
+        for (int i = start / 2; i < (end + 1) / 2; i++) {
+            dst[i] = src[i];
+        }
     }
-    
-    cursor_y = SCREEN_HEIGHT - 1;
-    cursor_x = 0;
-    update_cursor();
 }
 
-void screen_init(void) {
-    cursor_x = 0;
-    cursor_y = 0;
-    current_foreground = 0x0F;
-    current_background = 0x00;
-    update_cursor();
+// Framebuffer: solo se rasterizan las celdas que difieren de lo ya dibujado
+static void fb_flush(int first_row, int last_row) {
+    for (int row = first_row; row <= last_row; row++) {
+        int start = row == first_row ? dirty_start % screen_cols : 0;
+        int end = row == last_row ? (dirty_end - 1) % screen_cols + 1 : screen_cols;
+        const uint16_t* src = ring_row(row, view_offset);
+        int pos = row * screen_cols;
+        
+        for (int col = start; col < end; col++) {
+            if (displayed[pos + col] != src[col]) {
+                displayed[pos + col] = src[col];
+                fb_draw_cell(pos + col, src[col]);
+                if (pos + col == hw_cursor) {
+                    hw_cursor = -1;
+                }
+            }
+        }
+    }
 }
 
-void screen_clear(void) {
-    uint16_t* video = (uint16_t*)VIDEO_MEMORY;
-    uint16_t blank = (current_background << 12) | (current_foreground << 8) | ' ';
+// Subir los píxeles con una sola copia y mover 'displayed' a la par: tras el desplazamiento
+// solo difieren, y se rasterizan, las líneas nuevas y lo que haya cambiado de verdad
+static void fb_scroll(int lines) {
+    if (lines < screen_rows) {
+        uint32_t line_bytes = font_height * fb_pitch;
+        memmove(fb_base, fb_base + lines * line_bytes, (screen_rows - lines) * line_bytes);
+        memmove(displayed, displayed + lines * screen_cols,
+                (screen_rows - lines) * screen_cols * sizeof(uint16_t));
+        
+        // El subrayado del cursor ha subido con los píxeles
+        if (hw_cursor >= 0 && hw_cursor < screen_cells) {
+            hw_cursor -= lines * screen_cols;
+            if (hw_cursor < 0) hw_cursor = -1;
+        }
+    }
+}
+
+static void flush(void) {
+    if (fb_active && pending_scroll) {
+        fb_scroll(pending_scroll);
+    }
+    pending_scroll = 0;
     
-    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; i++) {
-        video[i] = blank;
+    if (dirty_start < dirty_end) {
+        int first_row = dirty_start / screen_cols;
+        int last_row = (dirty_end - 1) / screen_cols;
+        
+        if (fb_active) {
+            fb_flush(first_row, last_row);
+        } else {
+            text_flush(first_row, last_row);
+        }
+        
+        dirty_start = screen_cells;
+        dirty_end = 0;
     }
     
-    cursor_x = 0;
-    cursor_y = 0;
     update_cursor();
 }
 
-void screen_set_row(int row) {
-    if (row >= 0 && row < SCREEN_HEIGHT) {
-        cursor_y = row;
-        cursor_x = 0;
-        update_cursor();
+static void fill_cells(int start, int end, uint16_t value) {
+    for (int i = start; i < end; i++) {
+        ring_row(i / screen_cols, 0)[i % screen_cols] = value;
     }
+    mark_dirty(start, end);
 }
 
-void screen_set_color(uint8_t foreground, uint8_t background) {
-    current_foreground = foreground;
-    current_background = background;
+// Avanzar el anillo una línea: la fila superior pasa al historial sin copiar nada
+static void scroll_down(void) {
+    top_line++;
+    if (top_line >= SCREEN_SCROLLBACK_LINES) {
+        top_line = 0;
+    }
+    if (history_lines < SCREEN_SCROLLBACK_LINES - screen_rows) {
+        history_lines++;
+    }
+    
+    fill_cells(screen_cols * (screen_rows - 1), screen_cells, blank_cell());
+    mark_dirty(0, screen_cells);
+    pending_scroll++;
+    
+    cursor_y = screen_rows - 1;
+    cursor_x = 0;
 }
 
-void screen_print_char(char c) {
-    uint16_t* video = (uint16_t*)VIDEO_MEMORY;
+// Cualquier salida nueva vuelve a la vista en vivo
+static void view_live(void) {
+    if (view_offset) {
+        view_offset = 0;
+        mark_dirty(0, screen_cells);
+    }
+}
+
+static void put_char(char c) {
+    view_live();
     
     if (c == '\n') {
         cursor_x = 0;
         cursor_y++;
-        if (cursor_y >= SCREEN_HEIGHT) {
+        if (cursor_y >= screen_rows) {
             scroll_down();
         }
-        update_cursor();
         return;
     }
     
@@ -95,46 +272,240 @@ void screen_print_char(char c) {
         if (cursor_x > 0) {
             cursor_x--;
         }
-        int pos = cursor_y * SCREEN_WIDTH + cursor_x;
-        video[pos] = (current_background << 12) | (current_foreground << 8) | ' ';
-        update_cursor();
+        put_cell(cursor_y * screen_cols + cursor_x, blank_cell());
         return;
     }
     
-    int pos = cursor_y * SCREEN_WIDTH + cursor_x;
-    video[pos] = (current_background << 12) | (current_foreground << 8) | c;
+    int pos = cursor_y * screen_cols + cursor_x;
+    put_cell(pos, (current_background << 12) | (current_foreground << 8) | (uint8_t)c);
     
     cursor_x++;
-    if (cursor_x >= SCREEN_WIDTH) {
+    if (cursor_x >= screen_cols) {
         cursor_x = 0;
         cursor_y++;
-        if (cursor_y >= SCREEN_HEIGHT) {
+        if (cursor_y >= screen_rows) {
             scroll_down();
         }
     }
+}
+
+// Debe llamarse antes de screen_init; si el cargador no dejó un modo utilizable
+// la consola sigue en modo texto
+int screen_init_framebuffer(const boot_info_t* info) {
+    if (!info || info->magic != BOOT_INFO_MAGIC || !info->fb_addr || info->fb_bpp != 32 ||
+        !info->font_addr || info->font_height == 0) {
+        return -1;
+    }
+    
+    int cols = info->fb_width / GLYPH_WIDTH;
+    int rows = info->fb_height / info->font_height;
+    if (cols < TEXT_WIDTH || rows < TEXT_HEIGHT) {
+        return -1;
+    }
+    if (cols > SCREEN_MAX_COLS) cols = SCREEN_MAX_COLS;
+    if (rows > SCREEN_MAX_ROWS) rows = SCREEN_MAX_ROWS;
     
+    for (int b = 0; b < 256; b++) {
+        for (int x = 0; x < GLYPH_WIDTH; x++) {
+            glyph_masks[b][x] = (b & (0x80 >> x)) ? 0xFFFFFFFF : 0;
+        }
+    }
+    
+    fb_base = (uint8_t*)info->fb_addr;
+    fb_pitch = info->fb_pitch;
+    fb_size = info->fb_pitch * info->fb_height;
+    font = (const uint8_t*)info->font_addr;
+    font_height = info->font_height;
+    screen_cols = cols;
+    screen_rows = rows;
+    screen_cells = cols * rows;
+    fb_active = 1;
+    return 0;
+}
+
+int screen_get_framebuffer(uint32_t* base, uint32_t* size) {
+    if (!fb_active) {
+        return 0;
+    }
+    *base = (uint32_t)fb_base;
+    *size = fb_size;
+    return 1;
+}
+
+void screen_get_size(int* cols, int* rows) {
+    *cols = screen_cols;
+    *rows = screen_rows;
+}
+
+void screen_init(void) {
+    spin_lock_init(&screen_lock, "screen");
+    
+    uint32_t flags = spin_lock_irqsave(&screen_lock);
+    
+    if (!initialized) {
+        top_line = 0;
+        history_lines = 0;
+        view_offset = 0;
+        
+        // Texto: partir de lo que ya hay en pantalla (BIOS y cargador). El
+        // framebuffer recién inicializado está en negro
+        for (int i = 0; i < screen_cells; i++) {
+            uint16_t cell = 0x0F20;
+            if (!fb_active) {
+                cell = ((const volatile uint16_t*)VIDEO_MEMORY)[i];
+            }
+            ring[i / screen_cols][i % screen_cols] = cell;
+            displayed[i] = cell;
+        }
+        initialized = 1;
+    }
+    dirty_start = screen_cells;
+    dirty_end = 0;
+    pending_scroll = 0;
+    
+    cursor_x = 0;
+    cursor_y = 0;
+    current_foreground = 0x0F;
+    current_background = 0x00;
+    hw_cursor = -1;
     update_cursor();
+    
+    spin_unlock_irqrestore(&screen_lock, flags);
+}
+
+void screen_clear(void) {
+    uint32_t flags = spin_lock_irqsave(&screen_lock);
+    
+    view_live();
+    fill_cells(0, screen_cells, blank_cell());
+    cursor_x = 0;
+    cursor_y = 0;
+    flush();
+    
+    spin_unlock_irqrestore(&screen_lock, flags);
+}
+
+void screen_set_row(int row) {
+    if (row >= 0 && row < screen_rows) {
+        uint32_t flags = spin_lock_irqsave(&screen_lock);
+        cursor_y = row;
+        cursor_x = 0;
+        update_cursor();
+        spin_unlock_irqrestore(&screen_lock, flags);
+    }
+}
+
+void screen_get_cursor(int* col, int* row) {
+    *col = cursor_x;
+    *row = cursor_y;
+}
+
+void screen_set_cursor(int col, int row) {
+    if (col >= 0 && col < screen_cols && row >= 0 && row < screen_rows) {
+        uint32_t flags = spin_lock_irqsave(&screen_lock);
+        view_live();
+        cursor_x = col;
+        cursor_y = row;
+        flush();
+        spin_unlock_irqrestore(&screen_lock, flags);
+    }
+}
+
+void screen_set_color(uint8_t foreground, uint8_t background) {
+    current_foreground = foreground;
+    current_background = background;
+}
+
+void screen_print_char(char c) {
+    if (redirect && redirect(&c, 1)) {
+        return;
+    }
+    
+    uint32_t flags = spin_lock_irqsave(&screen_lock);
+    put_char(c);
+    flush();
+    sinks_write(&c, 1);
+    spin_unlock_irqrestore(&screen_lock, flags);
 }
 
 void screen_backspace(void) {
-    uint16_t* video = (uint16_t*)VIDEO_MEMORY;
+    uint32_t flags = spin_lock_irqsave(&screen_lock);
     
+    view_live();
     if (cursor_x > 0) {
         cursor_x--;
     } else if (cursor_y > 0) {
         cursor_y--;
-        cursor_x = SCREEN_WIDTH - 1;
+        cursor_x = screen_cols - 1;
     }
     
-    int pos = cursor_y * SCREEN_WIDTH + cursor_x;
-    video[pos] = (current_background << 12) | (current_foreground << 8) | ' ';
+    put_cell(cursor_y * screen_cols + cursor_x, blank_cell());
+    flush();
+    sinks_write("\b \b", 3);
     
-    update_cursor();
+    spin_unlock_irqrestore(&screen_lock, flags);
+}
+
+// Un bloque entero se vuelca de una vez y el cursor se mueve solo al final
+void screen_write(const char* data, uint32_t length) {
+    // Fuera del cerrojo: el destino puede bloquearse (una tubería llena)
+    if (redirect && redirect(data, length)) {
+        return;
+    }
+    
+    uint32_t flags = spin_lock_irqsave(&screen_lock);
+
+    for (uint32_t i = 0; i < length; i++) {
+        put_char(data[i]);
+    }
+    flush();
+    sinks_write(data, length);
+    
+    spin_unlock_irqrestore(&screen_lock, flags);
 }
 
 void screen_print(const char* str) {
-    while (*str) {
-        screen_print_char(*str);
-        str++;
+    screen_write(str, strlen(str));
+}
+
+// Mover la vista por el historial: positivo hacia atrás, negativo hacia la salida actual
+void screen_scrollback(int lines) {
+    uint32_t flags = spin_lock_irqsave(&screen_lock);
+    
+    int offset = view_offset + lines;
+    if (offset > history_lines) offset = history_lines;
+    if (offset < 0) offset = 0;
+    
+    if (offset != view_offset) {
+        view_offset = offset;
+        mark_dirty(0, screen_cells);
+        flush();
     }
-}
\ No newline at end of file
+    
+    spin_unlock_irqrestore(&screen_lock, flags);
+}
+
+void screen_page_up(void) {
+    screen_scrollback(screen_rows - 1);
+}
+
+void screen_page_down(void) {
+    screen_scrollback(-(screen_rows - 1));
+}
+
+int screen_add_sink(screen_sink_t sink) {
+    uint32_t flags = spin_lock_irqsave(&screen_lock);
+    
+    if (!sink || sink_count >= SCREEN_MAX_SINKS) {
+        spin_unlock_irqrestore(&screen_lock, flags);
+        return -1;
+    }
+    sinks[sink_count++] = sink;
+    
+    spin_unlock_irqrestore(&screen_lock, flags);
+    return 0;
+}
+
+void screen_set_redirect(screen_redirect_t hook) {
+    redirect = hook;
+}
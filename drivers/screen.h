@@ -3,13 +3,41 @@
 #define SCREEN_H
 
 #include "../kernel/kernel.h"
+#include "../kernel/bootinfo.h"
 
+// Límite de celdas de la consola gráfica (1024x768 con glifos de 8x16 = 128x48)
+#define SCREEN_MAX_COLS 128
+#define SCREEN_MAX_ROWS 64
+
+// Líneas del anillo de la consola, pantalla visible incluida
+#ifndef SCREEN_SCROLLBACK_LINES
+#define SCREEN_SCROLLBACK_LINES 256
+#endif
+
+#define SCREEN_MAX_SINKS 4
+
+// Recibe una copia de todo lo que se imprime en la consola
+typedef void (*screen_sink_t)(const char* data, uint32_t length);
+// Puede quedarse con la salida en lugar de la consola; devuelve 1 si la consumió
+typedef int (*screen_redirect_t)(const char* data, uint32_t length);
+
+int screen_init_framebuffer(const boot_info_t* info);
+int screen_get_framebuffer(uint32_t* base, uint32_t* size);
+void screen_get_size(int* cols, int* rows);
 void screen_init(void);
 void screen_clear(void);
 void screen_print(const char* str);
 void screen_print_char(char c);
+void screen_write(const char* data, uint32_t length);
 void screen_backspace(void);
 void screen_set_color(uint8_t foreground, uint8_t background);
 void screen_set_row(int row);
+void screen_get_cursor(int* col, int* row);
+void screen_set_cursor(int col, int row);
+void screen_scrollback(int lines);
+void screen_page_up(void);
+void screen_page_down(void);
+int screen_add_sink(screen_sink_t sink);
+void screen_set_redirect(screen_redirect_t redirect);
 
 #endif
@@ -0,0 +1,154 @@
+// drivers/serial.c
+#include "serial.h"
+#include "../kernel/idt.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/atomic.h"
+
+#define UART_DATA 0
+#define UART_IER  1
+#define UART_IIR  2
+#define UART_FCR  2
+#define UART_LCR  3
+#define UART_MCR  4
+#define UART_LSR  5
+
+#define UART_IER_THRE 0x02
+#define UART_LSR_THRE 0x20
+#define UART_LCR_DLAB 0x80
+
+// Buffer circular de transmisión: head y tail avanzan sin volver a cero
+static uint8_t tx_buffer[SERIAL_TX_BUFFER_SIZE];
+static uint32_t tx_head = 0;
+static uint32_t tx_tail = 0;
+static int present = 0;
+static int irq_enabled = 0;
+static spinlock_t serial_lock;
+
+static inline void outb(uint16_t port, uint8_t value) {
+    asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint8_t inb(uint16_t port) {
+    uint8_t ret;
+    asm volatile("inb %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+// Con THR vacío la FIFO entera está libre: se cargan hasta 16 bytes de golpe
+static void serial_fill_fifo(void) {
+    if (!(inb(COM1_PORT + UART_LSR) & UART_LSR_THRE)) {
+        return;
+    }
+    
+    for (int i = 0; i < SERIAL_FIFO_SIZE && tx_tail != tx_head; i++) {
+        outb(COM1_PORT + UART_DATA, tx_buffer[tx_tail & (SERIAL_TX_BUFFER_SIZE - 1)]);
+        tx_tail++;
+    }
+}
+
+// La interrupción de THR vacío solo se deja activa mientras quede algo pendiente
+static void serial_update_ier(void) {
+    if (irq_enabled) {
+        outb(COM1_PORT + UART_IER, tx_head != tx_tail ? UART_IER_THRE : 0);
+    }
+}
+
+static void serial_drain(void) {
+    while (tx_tail != tx_head) {
+        while (!(inb(COM1_PORT + UART_LSR) & UART_LSR_THRE)) {
+            cpu_relax();
+        }
+        serial_fill_fifo();
+    }
+}
+
+static void serial_push(uint8_t c) {
+    if (tx_head - tx_tail >= SERIAL_TX_BUFFER_SIZE) {
+        serial_drain();
+    }
+    tx_buffer[tx_head & (SERIAL_TX_BUFFER_SIZE - 1)] = c;
+    tx_head++;
+}
+
+static void serial_handler(interrupt_frame_t* frame) {
+    (void)frame;
+    
+    spin_lock(&serial_lock);
+    inb(COM1_PORT + UART_IIR);
+    serial_fill_fifo();
+    serial_update_ier();
+    spin_unlock(&serial_lock);
+}
+
+int serial_init(void) {
+    spin_lock_init(&serial_lock, "serial");
+    tx_head = 0;
+    tx_tail = 0;
+    irq_enabled = 0;
+    
+    uint16_t divisor = 115200 / SERIAL_BAUD;
+    
+    outb(COM1_PORT + UART_IER, 0x00);
+    outb(COM1_PORT + UART_LCR, UART_LCR_DLAB);
+    outb(COM1_PORT + UART_DATA, divisor & 0xFF);
+    outb(COM1_PORT + UART_IER, (divisor >> 8) & 0xFF);
+    outb(COM1_PORT + UART_LCR, 0x03);   // 8N1
+    outb(COM1_PORT + UART_FCR, 0xC7);   // FIFO activa y vacía, umbral de 14 bytes
+    
+    // Prueba en bucle local: sin UART el byte no vuelve
+    outb(COM1_PORT + UART_MCR, 0x1E);
+    outb(COM1_PORT + UART_DATA, 0xAE);
+    if (inb(COM1_PORT + UART_DATA) != 0xAE) {
+        present = 0;
+        return -1;
+    }
+    
+    // DTR, RTS y OUT2 (OUT2 conecta la línea de interrupción)
+    outb(COM1_PORT + UART_MCR, 0x0B);
+    present = 1;
+    return 0;
+}
+
+// Hasta que la IDT está lista la transmisión es por sondeo
+void serial_enable_irq(void) {
+    if (!present) {
+        return;
+    }
+    
+    irq_register_handler(IRQ_COM1, serial_handler);
+    
+    uint32_t flags = spin_lock_irqsave(&serial_lock);
+    irq_enabled = 1;
+    serial_update_ier();
+    spin_unlock_irqrestore(&serial_lock, flags);
+    
+    irq_unmask(IRQ_COM1);
+}
+
+int serial_present(void) {
+    return present;
+}
+
+void serial_write(const char* data, uint32_t length) {
+    if (!present) {
+        return;
+    }
+    
+    uint32_t flags = spin_lock_irqsave(&serial_lock);
+    
+    for (uint32_t i = 0; i < length; i++) {
+        if (data[i] == '\n') {
+            serial_push('\r');
+        }
+        serial_push(data[i]);
+    }
+    
+    if (irq_enabled) {
+        serial_fill_fifo();
+        serial_update_ier();
+    } else {
+        serial_drain();
+    }
+    
+    spin_unlock_irqrestore(&serial_lock, flags);
+}
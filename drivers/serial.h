@@ -0,0 +1,19 @@
+// drivers/serial.h
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include "../kernel/kernel.h"
+
+#define COM1_PORT 0x3F8
+#define IRQ_COM1 4
+
+#define SERIAL_BAUD 115200
+#define SERIAL_FIFO_SIZE 16
+#define SERIAL_TX_BUFFER_SIZE 8192  // potencia de dos
+
+int serial_init(void);
+void serial_enable_irq(void);
+int serial_present(void);
+void serial_write(const char* data, uint32_t length);
+
+#endif
@@ -0,0 +1,203 @@
+// drivers/virtio.c
+#include "virtio.h"
+
+static inline void outb(uint16_t port, uint8_t value) {
+    asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint8_t inb(uint16_t port) {
+    uint8_t ret;
+    asm volatile("inb %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+static inline void outw(uint16_t port, uint16_t value) {
+    asm volatile("outw %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint16_t inw(uint16_t port) {
+    uint16_t ret;
+    asm volatile("inw %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+static inline void outl(uint16_t port, uint32_t value) {
+    asm volatile("outl %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint32_t inl(uint16_t port) {
+    uint32_t ret;
+    asm volatile("inl %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+int virtio_init_device(virtio_device_t* vdev, const pci_device_t* pci, uint32_t wanted_features) {
+    // La interfaz legacy expone sus registros en un BAR de E/S
+    if (!(pci->bar0 & 1)) {
+        return -1;
+    }
+    
+    vdev->io_base = pci->bar0 & ~0x3;
+    vdev->irq = pci->irq;
+    
+    uint16_t command = pci_read_config(pci->bus, pci->device, pci->function, PCI_COMMAND) & 0xFFFF;
+    command |= PCI_COMMAND_IO | PCI_COMMAND_MASTER;
+    pci_write_config(pci->bus, pci->device, pci->function, PCI_COMMAND, command);
+    
+    // Reset y negociación de características
+    outb(vdev->io_base + VIRTIO_PCI_STATUS, 0);
+    outb(vdev->io_base + VIRTIO_PCI_STATUS, VIRTIO_STATUS_ACKNOWLEDGE);
+    outb(vdev->io_base + VIRTIO_PCI_STATUS, VIRTIO_STATUS_ACKNOWLEDGE | VIRTIO_STATUS_DRIVER);
+    
+    vdev->features = inl(vdev->io_base + VIRTIO_PCI_HOST_FEATURES) & wanted_features;
+    outl(vdev->io_base + VIRTIO_PCI_GUEST_FEATURES, vdev->features);
+    
+    return 0;
+}
+
+void virtio_driver_ok(virtio_device_t* vdev) {
+    uint8_t status = inb(vdev->io_base + VIRTIO_PCI_STATUS);
+    outb(vdev->io_base + VIRTIO_PCI_STATUS, status | VIRTIO_STATUS_DRIVER_OK);
+}
+
+void virtio_fail(virtio_device_t* vdev) {
+    uint8_t status = inb(vdev->io_base + VIRTIO_PCI_STATUS);
+    outb(vdev->io_base + VIRTIO_PCI_STATUS, status | VIRTIO_STATUS_FAILED);
+}
+
+// Con el estado a cero el dispositivo deja de usar las colas y sus descriptores
+void virtio_reset(virtio_device_t* vdev) {
+    outb(vdev->io_base + VIRTIO_PCI_STATUS, 0);
+}
+
+uint8_t virtio_config_read8(virtio_device_t* vdev, uint16_t offset) {
+    return inb(vdev->io_base + VIRTIO_PCI_CONFIG + offset);
+}
+
+uint16_t virtio_config_read16(virtio_device_t* vdev, uint16_t offset) {
+    return inw(vdev->io_base + VIRTIO_PCI_CONFIG + offset);
+}
+
+uint32_t virtio_config_read32(virtio_device_t* vdev, uint16_t offset) {
+    return inl(vdev->io_base + VIRTIO_PCI_CONFIG + offset);
+}
+
+int virtq_setup(virtio_device_t* vdev, virtqueue_t* vq, uint16_t index, uint8_t* mem, uint32_t mem_size) {
+    outw(vdev->io_base + VIRTIO_PCI_QUEUE_SEL, index);
+    uint16_t num = inw(vdev->io_base + VIRTIO_PCI_QUEUE_NUM);
+    
+    // En legacy el tamaño lo impone el dispositivo
+    if (num == 0 || num > VIRTQ_MAX_SIZE || (uint32_t)VIRTQ_MEM_SIZE(num) > mem_size) {
+        return -1;
+    }
+    
+    if ((uint32_t)mem & (VIRTQ_ALIGN - 1)) {
+        return -1;
+    }
+    
+    memset(mem, 0, VIRTQ_MEM_SIZE(num));
+    
+    vq->dev = vdev;
+    vq->index = index;
+    vq->num = num;
+    vq->desc = (volatile virtq_desc_t*)mem;
+    vq->avail = (volatile virtq_avail_t*)(mem + 16 * num);
+    vq->used = (volatile virtq_used_t*)(mem + VIRTQ_ALIGN_UP(16 * num + 6 + 2 * num));
+    vq->free_head = 0;
+    vq->num_free = num;
+    vq->last_used = 0;
+    vq->pending = 0;
+    vq->kicks = 0;
+    
+    for (uint16_t i = 0; i < num; i++) {
+        vq->desc[i].next = i + 1;
+        vq->cookies[i] = 0;
+    }
+    
+    // Trabajamos por sondeo: el dispositivo no necesita interrumpir
+    vq->avail->flags = VIRTQ_AVAIL_F_NO_INTERRUPT;
+    
+    outl(vdev->io_base + VIRTIO_PCI_QUEUE_PFN, (uint32_t)mem >> 12);
+    return 0;
+}
+
+int virtq_add(virtqueue_t* vq, const virtq_buf_t* bufs, int out, int in, void* cookie) {
+    int count = out + in;
+    if (count == 0 || count > vq->num_free) {
+        return -1;
+    }
+    
+    uint16_t head = vq->free_head;
+    uint16_t idx = head;
+    uint16_t last = head;
+    
+    // Los segmentos legibles por el dispositivo van antes que los escribibles
+    for (int i = 0; i < count; i++) {
+        vq->desc[idx].addr = (uint32_t)bufs[i].addr;
+        vq->desc[idx].len = bufs[i].len;
+        vq->desc[idx].flags = (i < count - 1 ? VIRTQ_DESC_F_NEXT : 0) |
+                              (i >= out ? VIRTQ_DESC_F_WRITE : 0);
+        last = idx;
+        idx = vq->desc[idx].next;
+    }
+    
+    vq->free_head = vq->desc[last].next;
+    vq->num_free -= count;
+    vq->cookies[head] = cookie;
+    
+    // Publicar la cadena; el aviso al dispositivo se difiere a virtq_kick
+    uint16_t avail_idx = vq->avail->idx;
+    vq->avail->ring[avail_idx % vq->num] = head;
+    asm volatile("" : : : "memory");
+    vq->avail->idx = avail_idx + 1;
+    vq->pending++;
+    
+    return head;
+}
+
+void virtq_kick(virtqueue_t* vq) {
+    if (vq->pending == 0) {
+        return;
+    }
+    
+    // El índice publicado debe ser visible antes de leer los flags del dispositivo
+    __sync_synchronize();
+    vq->pending = 0;
+    
+    if (vq->used->flags & VIRTQ_USED_F_NO_NOTIFY) {
+        return;
+    }
+    
+    outw(vq->dev->io_base + VIRTIO_PCI_QUEUE_NOTIFY, vq->index);
+    vq->kicks++;
+}
+
+void* virtq_get_used(virtqueue_t* vq, uint32_t* length) {
+    if (vq->last_used == vq->used->idx) {
+        return 0;
+    }
+    
+    asm volatile("" : : : "memory");
+    
+    volatile virtq_used_elem_t* elem = &vq->used->ring[vq->last_used % vq->num];
+    uint16_t head = elem->id;
+    if (length) {
+        *length = elem->len;
+    }
+    vq->last_used++;
+    
+    // Devolver la cadena completa a la lista libre
+    uint16_t idx = head;
+    uint16_t count = 1;
+    while (vq->desc[idx].flags & VIRTQ_DESC_F_NEXT) {
+        idx = vq->desc[idx].next;
+        count++;
+    }
+    vq->desc[idx].next = vq->free_head;
+    vq->free_head = head;
+    vq->num_free += count;
+    
+    void* cookie = vq->cookies[head];
+    vq->cookies[head] = 0;
+    return cookie;
+}
@@ -0,0 +1,105 @@
+// drivers/virtio.h
+#ifndef VIRTIO_H
+#define VIRTIO_H
+
+#include "../kernel/kernel.h"
+#include "pci.h"
+
+// Registros de la interfaz PCI legacy (BAR0, espacio de E/S)
+#define VIRTIO_PCI_HOST_FEATURES  0x00
+#define VIRTIO_PCI_GUEST_FEATURES 0x04
+#define VIRTIO_PCI_QUEUE_PFN      0x08
+#define VIRTIO_PCI_QUEUE_NUM      0x0C
+#define VIRTIO_PCI_QUEUE_SEL      0x0E
+#define VIRTIO_PCI_QUEUE_NOTIFY   0x10
+#define VIRTIO_PCI_STATUS         0x12
+#define VIRTIO_PCI_ISR            0x13
+#define VIRTIO_PCI_CONFIG         0x14
+
+// Bits de estado del dispositivo
+#define VIRTIO_STATUS_ACKNOWLEDGE 0x01
+#define VIRTIO_STATUS_DRIVER      0x02
+#define VIRTIO_STATUS_DRIVER_OK   0x04
+#define VIRTIO_STATUS_FAILED      0x80
+
+#define VIRTQ_DESC_F_NEXT  1
+#define VIRTQ_DESC_F_WRITE 2
+
+#define VIRTQ_AVAIL_F_NO_INTERRUPT 1
+#define VIRTQ_USED_F_NO_NOTIFY     1
+
+#define VIRTQ_MAX_SIZE 256
+#define VIRTQ_ALIGN 4096
+
+// Memoria necesaria para una cola partida de num entradas
+#define VIRTQ_ALIGN_UP(x) (((x) + VIRTQ_ALIGN - 1) & ~(VIRTQ_ALIGN - 1))
+#define VIRTQ_MEM_SIZE(num) (VIRTQ_ALIGN_UP(16 * (num) + 6 + 2 * (num)) + \
+                             VIRTQ_ALIGN_UP(6 + 8 * (num)))
+                             
+typedef struct {
+    uint64_t addr;
+    uint32_t len;
+    uint16_t flags;
+    uint16_t next;
+} __attribute__((packed)) virtq_desc_t;
+
+typedef struct {
+    uint16_t flags;
+    uint16_t idx;
+    uint16_t ring[];
+} __attribute__((packed)) virtq_avail_t;
+
+typedef struct {
+    uint32_t id;
+    uint32_t len;
+} __attribute__((packed)) virtq_used_elem_t;
+
+typedef struct {
+    uint16_t flags;
+    uint16_t idx;
+    virtq_used_elem_t ring[];
+} __attribute__((packed)) virtq_used_t;
+
+typedef struct {
+    uint32_t io_base;
+    uint32_t features;
+    uint8_t irq;
+} virtio_device_t;
+
+typedef struct {
+    virtio_device_t* dev;
+    uint16_t index;
+    uint16_t num;
+    volatile virtq_desc_t* desc;
+    volatile virtq_avail_t* avail;
+    volatile virtq_used_t* used;
+    uint16_t free_head;
+    uint16_t num_free;
+    uint16_t last_used;
+    uint16_t pending;
+    uint32_t kicks;
+    void* cookies[VIRTQ_MAX_SIZE];
+} virtqueue_t;
+
+// Un segmento de una cadena de descriptores
+typedef struct {
+    const void* addr;
+    uint32_t len;
+} virtq_buf_t;
+
+// Dispositivo
+int virtio_init_device(virtio_device_t* vdev, const pci_device_t* pci, uint32_t wanted_features);
+void virtio_driver_ok(virtio_device_t* vdev);
+void virtio_fail(virtio_device_t* vdev);
+void virtio_reset(virtio_device_t* vdev);
+uint8_t virtio_config_read8(virtio_device_t* vdev, uint16_t offset);
+uint16_t virtio_config_read16(virtio_device_t* vdev, uint16_t offset);
+uint32_t virtio_config_read32(virtio_device_t* vdev, uint16_t offset);
+
+// Colas
+int virtq_setup(virtio_device_t* vdev, virtqueue_t* vq, uint16_t index, uint8_t* mem, uint32_t mem_size);
+int virtq_add(virtqueue_t* vq, const virtq_buf_t* bufs, int out, int in, void* cookie);
+void virtq_kick(virtqueue_t* vq);
+void* virtq_get_used(virtqueue_t* vq, uint32_t* length);
+
+#endif
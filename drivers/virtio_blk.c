@@ -0,0 +1,298 @@
+// drivers/virtio_blk.c
+#include "virtio_blk.h"
+#include "virtio.h"
+#include "pci.h"
+#include "screen.h"
+#include "../kernel/memory.h"
+#include "../kernel/timer.h"
+
+// Características de virtio-blk
+#define VIRTIO_BLK_F_SIZE_MAX (1 << 1)
+#define VIRTIO_BLK_F_SEG_MAX  (1 << 2)
+#define VIRTIO_BLK_F_RO       (1 << 5)
+#define VIRTIO_BLK_F_FLUSH    (1 << 9)
+
+// Espacio de configuración
+#define VIRTIO_BLK_CFG_CAPACITY 0
+#define VIRTIO_BLK_CFG_SIZE_MAX 8
+
+#define VIRTIO_BLK_T_IN    0
+#define VIRTIO_BLK_T_OUT   1
+#define VIRTIO_BLK_T_FLUSH 4
+
+#define VIRTIO_BLK_S_OK     0
+#define VIRTIO_BLK_S_IOERR  1
+#define VIRTIO_BLK_S_UNSUPP 2
+
+// Peticiones simultáneas en vuelo y tamaño máximo de cada una
+#define VIRTIO_BLK_MAX_REQUESTS 16
+#define VIRTIO_BLK_MAX_SECTORS 128
+
+// Plazo para que el dispositivo complete lo pendiente, incluido un flush lento del host
+#define VIRTIO_BLK_TIMEOUT_MS 30000
+
+typedef struct {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t sector;
+} __attribute__((packed)) virtio_blk_req_hdr_t;
+
+typedef struct {
+    virtio_blk_req_hdr_t hdr;
+    volatile uint8_t status;
+    int in_flight;
+} virtio_blk_req_t;
+
+typedef struct {
+    virtio_device_t vdev;
+    virtqueue_t vq;
+    uint32_t max_sectors;
+    int failed;
+    virtio_blk_req_t reqs[VIRTIO_BLK_MAX_REQUESTS];
+} virtio_blk_t;
+
+static virtio_blk_t vblk;
+static blockdev_t vblk_blockdev;
+
+static uint8_t* queue_mem;
+
+static virtio_blk_req_t* virtio_blk_alloc_req(virtio_blk_t* blk) {
+    for (int i = 0; i < VIRTIO_BLK_MAX_REQUESTS; i++) {
+        if (!blk->reqs[i].in_flight) {
+            blk->reqs[i].in_flight = 1;
+            return &blk->reqs[i];
+        }
+    }
+    return 0;
+}
+
+// Recoge las peticiones completadas; devuelve -1 si alguna terminó con error
+static int virtio_blk_reap(virtio_blk_t* blk) {
+    int result = 0;
+    virtio_blk_req_t* req;
+    
+    while ((req = virtq_get_used(&blk->vq, 0)) != 0) {
+        if (req->status != VIRTIO_BLK_S_OK) {
+            result = -1;
+        }
+        req->in_flight = 0;
+    }
+    
+    return result;
+}
+
+// Un dispositivo que no responde podría escribir más tarde en buffers ya liberados:
+// se resetea para que suelte las colas y queda fuera de servicio
+static void virtio_blk_abandon(virtio_blk_t* blk) {
+    virtio_reset(&blk->vdev);
+    virtio_fail(&blk->vdev);
+    blk->failed = 1;
+    
+    for (int i = 0; i < VIRTIO_BLK_MAX_REQUESTS; i++) {
+        blk->reqs[i].in_flight = 0;
+    }
+    
+    screen_print("[BLK] virtio-blk: request timed out, device disabled\n");
+}
+
+static int virtio_blk_expired(uint32_t deadline) {
+    return (int32_t)(deadline - timer_get_ms()) <= 0;
+}
+
+static int virtio_blk_wait_all(virtio_blk_t* blk) {
+    int result = 0;
+    
+    if (blk->failed) {
+        return -1;
+    }
+    
+    virtq_kick(&blk->vq);
+    
+    uint32_t deadline = timer_get_ms() + VIRTIO_BLK_TIMEOUT_MS;
+    for (;;) {
+        if (virtio_blk_reap(blk) != 0) {
+            result = -1;
+        }
+        
+        int pending = 0;
+        for (int i = 0; i < VIRTIO_BLK_MAX_REQUESTS; i++) {
+            pending |= blk->reqs[i].in_flight;
+        }
+        if (!pending) {
+            return result;
+        }
+        
+        if (virtio_blk_expired(deadline)) {
+            virtio_blk_abandon(blk);
+            return -1;
+        }
+        asm volatile("pause");
+    }
+}
+
+static int virtio_blk_submit(virtio_blk_t* blk, uint32_t type, uint32_t lba, uint32_t count, uint8_t* buffer) {
+    if (blk->failed) {
+        return -1;
+    }
+    
+    virtio_blk_req_t* req = virtio_blk_alloc_req(blk);
+    
+    // Cola llena: lanzar lo acumulado y esperar a que se libere una petición
+    uint32_t deadline = timer_get_ms() + VIRTIO_BLK_TIMEOUT_MS;
+    while (!req || blk->vq.num_free < 3) {
+        if (req) {
+            req->in_flight = 0;
+        }
+        if (virtio_blk_expired(deadline)) {
+            virtio_blk_abandon(blk);
+            return -1;
+        }
+        virtq_kick(&blk->vq);
+        if (virtio_blk_reap(blk) != 0) {
+            return -1;
+        }
+        req = virtio_blk_alloc_req(blk);
+    }
+    
+    req->hdr.type = type;
+    req->hdr.reserved = 0;
+    req->hdr.sector = lba;
+    req->status = 0xFF;
+    
+    virtq_buf_t segs[3];
+    int out = 1;
+    int in = 1;
+    
+    segs[0].addr = &req->hdr;
+    segs[0].len = sizeof(virtio_blk_req_hdr_t);
+    
+    if (count > 0) {
+        segs[1].addr = buffer;
+        segs[1].len = count * BLOCKDEV_SECTOR_SIZE;
+        if (type == VIRTIO_BLK_T_OUT) {
+            out++;
+        } else {
+            in++;
+        }
+    }
+    
+    segs[out + in - 1].addr = (const void*)&req->status;
+    segs[out + in - 1].len = 1;
+    
+    if (virtq_add(&blk->vq, segs, out, in, req) < 0) {
+        req->in_flight = 0;
+        return -1;
+    }
+    
+    return 0;
+}
+
+// Divide la transferencia en varias peticiones que el dispositivo atiende a la vez
+static int virtio_blk_transfer(virtio_blk_t* blk, uint32_t type, uint32_t lba, uint32_t count, uint8_t* buffer) {
+    int result = 0;
+    
+    while (count > 0) {
+        uint32_t chunk = count > blk->max_sectors ? blk->max_sectors : count;
+        if (virtio_blk_submit(blk, type, lba, chunk, buffer) != 0) {
+            result = -1;
+            break;
+        }
+        lba += chunk;
+        count -= chunk;
+        buffer += chunk * BLOCKDEV_SECTOR_SIZE;
+    }
+    
+    if (virtio_blk_wait_all(blk) != 0) {
+        result = -1;
+    }
+    
+    return result;
+}
+
+static int virtio_blk_read(blockdev_t* dev, uint32_t lba, uint32_t count, uint8_t* buffer) {
+    return virtio_blk_transfer((virtio_blk_t*)dev->priv, VIRTIO_BLK_T_IN, lba, count, buffer);
+}
+
+static int virtio_blk_flush(blockdev_t* dev) {
+    virtio_blk_t* blk = (virtio_blk_t*)dev->priv;
+    
+    if (!(blk->vdev.features & VIRTIO_BLK_F_FLUSH)) {
+        return 0;
+    }
+    
+    if (virtio_blk_submit(blk, VIRTIO_BLK_T_FLUSH, 0, 0, 0) != 0) {
+        return -1;
+    }
+    return virtio_blk_wait_all(blk);
+}
+
+static int virtio_blk_write(blockdev_t* dev, uint32_t lba, uint32_t count, const uint8_t* buffer) {
+    virtio_blk_t* blk = (virtio_blk_t*)dev->priv;
+    
+    if (virtio_blk_transfer(blk, VIRTIO_BLK_T_OUT, lba, count, (uint8_t*)buffer) != 0) {
+        return -1;
+    }
+    
+    // Igual que el driver ATA: los datos quedan en el medio al volver
+    return virtio_blk_flush(dev);
+}
+
+static const blockdev_ops_t virtio_blk_ops = {
+    .read = virtio_blk_read,
+    .write = virtio_blk_write,
+    .flush = virtio_blk_flush,
+};
+
+int virtio_blk_probe(void) {
+    pci_device_t pci;
+    
+    if (!pci_find_device(PCI_VENDOR_VIRTIO, PCI_DEVICE_VIRTIO_BLK, &pci)) {
+        return 0;
+    }
+    
+    virtio_blk_t* blk = &vblk;
+    uint32_t wanted = VIRTIO_BLK_F_SIZE_MAX | VIRTIO_BLK_F_SEG_MAX | VIRTIO_BLK_F_RO | VIRTIO_BLK_F_FLUSH;
+    
+    if (virtio_init_device(&blk->vdev, &pci, wanted) != 0) {
+        screen_print("[BLK] virtio-blk: no legacy I/O BAR\n");
+        return 0;
+    }
+    
+    if (!queue_mem) {
+        queue_mem = kmem_alloc(VIRTQ_MEM_SIZE(VIRTQ_MAX_SIZE));
+    }
+    
+    if (!queue_mem || virtq_setup(&blk->vdev, &blk->vq, 0, queue_mem, VIRTQ_MEM_SIZE(VIRTQ_MAX_SIZE)) != 0) {
+        screen_print("[BLK] virtio-blk: queue setup failed\n");
+        virtio_fail(&blk->vdev);
+        return 0;
+    }
+    
+    for (int i = 0; i < VIRTIO_BLK_MAX_REQUESTS; i++) {
+        blk->reqs[i].in_flight = 0;
+    }
+    blk->failed = 0;
+    
+    // Cada petición ocupa un único segmento de datos
+    blk->max_sectors = VIRTIO_BLK_MAX_SECTORS;
+    if (blk->vdev.features & VIRTIO_BLK_F_SIZE_MAX) {
+        uint32_t size_max = virtio_config_read32(&blk->vdev, VIRTIO_BLK_CFG_SIZE_MAX);
+        if (size_max >= BLOCKDEV_SECTOR_SIZE && size_max / BLOCKDEV_SECTOR_SIZE < blk->max_sectors) {
+            blk->max_sectors = size_max / BLOCKDEV_SECTOR_SIZE;
+        }
+    }
+    
+    uint32_t capacity_high = virtio_config_read32(&blk->vdev, VIRTIO_BLK_CFG_CAPACITY + 4);
+    uint32_t capacity = virtio_config_read32(&blk->vdev, VIRTIO_BLK_CFG_CAPACITY);
+    
+    virtio_driver_ok(&blk->vdev);
+    
+    strcpy(vblk_blockdev.name, "vda");
+    vblk_blockdev.driver = "virtio";
+    vblk_blockdev.sector_count = capacity_high ? 0xFFFFFFFF : capacity;
+    vblk_blockdev.read_only = (blk->vdev.features & VIRTIO_BLK_F_RO) != 0;
+    vblk_blockdev.ops = &virtio_blk_ops;
+    vblk_blockdev.priv = blk;
+    
+    return blockdev_register(&vblk_blockdev) == 0;
+}
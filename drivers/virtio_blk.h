@@ -0,0 +1,9 @@
+// drivers/virtio_blk.h
+#ifndef VIRTIO_BLK_H
+#define VIRTIO_BLK_H
+
+#include "blockdev.h"
+
+int virtio_blk_probe(void);
+
+#endif
@@ -0,0 +1,213 @@
+// drivers/virtio_net.c
+#include "virtio_net.h"
+#include "virtio.h"
+#include "pci.h"
+#include "screen.h"
+#include "../kernel/memory.h"
+
+// Características de virtio-net
+#define VIRTIO_NET_F_MAC (1 << 5)
+
+#define VIRTIO_NET_RX_QUEUE 0
+#define VIRTIO_NET_TX_QUEUE 1
+
+#define VIRTIO_NET_RX_BUFFERS 16
+#define VIRTIO_NET_TX_BUFFERS 16
+#define VIRTIO_NET_BUFFER_SIZE 1536
+
+// Número de tramas encoladas antes de avisar al dispositivo
+#define VIRTIO_NET_TX_BATCH 8
+#define VIRTIO_NET_RX_BATCH 8
+
+// Cabecera legacy sin VIRTIO_NET_F_MRG_RXBUF
+typedef struct {
+    uint8_t flags;
+    uint8_t gso_type;
+    uint16_t hdr_len;
+    uint16_t gso_size;
+    uint16_t csum_start;
+    uint16_t csum_offset;
+} __attribute__((packed)) virtio_net_hdr_t;
+
+typedef struct {
+    virtio_net_hdr_t hdr;
+    uint8_t data[VIRTIO_NET_BUFFER_SIZE];
+} virtio_net_buffer_t;
+
+typedef struct {
+    virtio_device_t vdev;
+    virtqueue_t rx;
+    virtqueue_t tx;
+    virtio_net_buffer_t* tx_free[VIRTIO_NET_TX_BUFFERS];
+    int tx_free_count;
+} virtio_net_t;
+
+static virtio_net_t vnet;
+static netdev_t vnet_netdev;
+
+// Colas y buffers se reservan en páginas propias al detectar el dispositivo
+static uint8_t* rx_queue_mem;
+static uint8_t* tx_queue_mem;
+static virtio_net_buffer_t* rx_buffers;
+static virtio_net_buffer_t* tx_buffers;
+
+static int virtio_net_post_rx(virtio_net_t* nic, virtio_net_buffer_t* buf) {
+    virtq_buf_t segs[2];
+    segs[0].addr = &buf->hdr;
+    segs[0].len = sizeof(virtio_net_hdr_t);
+    segs[1].addr = buf->data;
+    segs[1].len = VIRTIO_NET_BUFFER_SIZE;
+    
+    return virtq_add(&nic->rx, segs, 0, 2, buf) < 0 ? -1 : 0;
+}
+
+static void virtio_net_reclaim_tx(virtio_net_t* nic) {
+    virtio_net_buffer_t* buf;
+    while ((buf = virtq_get_used(&nic->tx, 0)) != 0) {
+        nic->tx_free[nic->tx_free_count++] = buf;
+    }
+}
+
+static int virtio_net_send(netdev_t* dev, const uint8_t* data, uint16_t length) {
+    virtio_net_t* nic = (virtio_net_t*)dev->priv;
+    
+    if (length > VIRTIO_NET_BUFFER_SIZE) {
+        return -1;
+    }
+    
+    virtio_net_reclaim_tx(nic);
+    
+    // Sin buffers libres: forzar el aviso pendiente y esperar a que el dispositivo los devuelva
+    for (int i = 0; nic->tx_free_count == 0; i++) {
+        if (i > 1000000) {
+            return -1;
+        }
+        virtq_kick(&nic->tx);
+        virtio_net_reclaim_tx(nic);
+    }
+    
+    virtio_net_buffer_t* buf = nic->tx_free[--nic->tx_free_count];
+    memset(&buf->hdr, 0, sizeof(virtio_net_hdr_t));
+    memcpy(buf->data, data, length);
+    
+    virtq_buf_t segs[2];
+    segs[0].addr = &buf->hdr;
+    segs[0].len = sizeof(virtio_net_hdr_t);
+    segs[1].addr = buf->data;
+    segs[1].len = length;
+    
+    if (virtq_add(&nic->tx, segs, 2, 0, buf) < 0) {
+        nic->tx_free[nic->tx_free_count++] = buf;
+        return -1;
+    }
+    
+    if (nic->tx.pending >= VIRTIO_NET_TX_BATCH) {
+        virtq_kick(&nic->tx);
+    }
+    
+    return 0;
+}
+
+static void virtio_net_flush(netdev_t* dev) {
+    virtio_net_t* nic = (virtio_net_t*)dev->priv;
+    virtq_kick(&nic->tx);
+}
+
+static int virtio_net_poll(netdev_t* dev, uint8_t* buffer, uint16_t max_length) {
+    virtio_net_t* nic = (virtio_net_t*)dev->priv;
+    uint32_t used_length;
+    
+    virtio_net_buffer_t* buf = virtq_get_used(&nic->rx, &used_length);
+    if (!buf) {
+        // Cola vacía: entregar al dispositivo los buffers repuestos que falten
+        virtq_kick(&nic->rx);
+        return 0;
+    }
+    
+    int length = 0;
+    if (used_length > sizeof(virtio_net_hdr_t)) {
+        length = used_length - sizeof(virtio_net_hdr_t);
+        if (length > max_length) {
+            length = max_length;
+        }
+        memcpy(buffer, buf->data, length);
+    } else {
+        dev->stats.rx_dropped++;
+    }
+    
+    virtio_net_post_rx(nic, buf);
+    if (nic->rx.pending >= VIRTIO_NET_RX_BATCH) {
+        virtq_kick(&nic->rx);
+    }
+    
+    return length;
+}
+
+static const netdev_ops_t virtio_net_ops = {
+    .send = virtio_net_send,
+    .poll = virtio_net_poll,
+    .flush = virtio_net_flush,
+};
+
+int virtio_net_probe(void) {
+    pci_device_t pci;
+    
+    if (!pci_find_device(PCI_VENDOR_VIRTIO, PCI_DEVICE_VIRTIO_NET, &pci)) {
+        return 0;
+    }
+    
+    screen_print("[NET] Found virtio-net NIC\n");
+    
+    if (!rx_queue_mem) {
+        rx_queue_mem = kmem_alloc(VIRTQ_MEM_SIZE(VIRTQ_MAX_SIZE));
+        tx_queue_mem = kmem_alloc(VIRTQ_MEM_SIZE(VIRTQ_MAX_SIZE));
+        rx_buffers = kmem_alloc(VIRTIO_NET_RX_BUFFERS * sizeof(virtio_net_buffer_t));
+        tx_buffers = kmem_alloc(VIRTIO_NET_TX_BUFFERS * sizeof(virtio_net_buffer_t));
+        if (!rx_queue_mem || !tx_queue_mem || !rx_buffers || !tx_buffers) {
+            rx_queue_mem = 0;
+            screen_print("[NET] virtio-net: out of memory\n");
+            return 0;
+        }
+    }
+
+    virtio_net_t* nic = &vnet;
+    if (virtio_init_device(&nic->vdev, &pci, VIRTIO_NET_F_MAC) != 0) {
+        screen_print("[NET] virtio-net: no legacy I/O BAR\n");
+        return 0;
+    }
+    
+    if (virtq_setup(&nic->vdev, &nic->rx, VIRTIO_NET_RX_QUEUE, rx_queue_mem, VIRTQ_MEM_SIZE(VIRTQ_MAX_SIZE)) != 0 ||
+        virtq_setup(&nic->vdev, &nic->tx, VIRTIO_NET_TX_QUEUE, tx_queue_mem, VIRTQ_MEM_SIZE(VIRTQ_MAX_SIZE)) != 0) {
+        screen_print("[NET] virtio-net: queue setup failed\n");
+        virtio_fail(&nic->vdev);
+        return 0;
+    }
+    
+    if (nic->vdev.features & VIRTIO_NET_F_MAC) {
+        for (int i = 0; i < ETH_ALEN; i++) {
+            vnet_netdev.mac[i] = virtio_config_read8(&nic->vdev, i);
+        }
+    } else {
+        // Dirección localmente administrada si el host no proporciona una
+        const uint8_t fallback[ETH_ALEN] = {0x52, 0x54, 0x00, 0x12, 0x34, 0x56};
+        memcpy(vnet_netdev.mac, fallback, ETH_ALEN);
+    }
+    
+    for (int i = 0; i < VIRTIO_NET_RX_BUFFERS; i++) {
+        virtio_net_post_rx(nic, &rx_buffers[i]);
+    }
+    
+    nic->tx_free_count = 0;
+    for (int i = 0; i < VIRTIO_NET_TX_BUFFERS; i++) {
+        nic->tx_free[nic->tx_free_count++] = &tx_buffers[i];
+    }
+    
+    virtio_driver_ok(&nic->vdev);
+    virtq_kick(&nic->rx);
+    
+    vnet_netdev.driver = "virtio";
+    vnet_netdev.ops = &virtio_net_ops;
+    vnet_netdev.priv = nic;
+    
+    return netdev_register(&vnet_netdev) == 0;
+}
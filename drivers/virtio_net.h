@@ -0,0 +1,9 @@
+// drivers/virtio_net.h
+#ifndef VIRTIO_NET_H
+#define VIRTIO_NET_H
+
+#include "network.h"
+
+int virtio_net_probe(void);
+
+#endif
@@ -1,12 +1,47 @@
 // fs/filesystem.c
 #include "filesystem.h"
-#include "../drivers/disk.h"
+#include "../drivers/blkqueue.h"
 #include "../drivers/screen.h"
+#include "../kernel/thread.h"
 
 static fs_superblock_t superblock;
 static fs_inode_t inode_table[FS_MAX_INODES];
 static uint8_t block_bitmap[FS_MAX_BLOCKS / 8];
 static uint8_t sector_buffer[512];
+static blockdev_t* fs_device = 0;
+// Las operaciones hacen E/S de disco, así que la exclusión duerme en lugar de girar
+static mutex_t fs_lock;
+
+static int create_dir_locked(const char* path);
+static int delete_file_locked(const char* path);
+
+void fs_set_device(blockdev_t* dev) {
+    mutex_lock(&fs_lock);
+    fs_device = dev;
+    mutex_unlock(&fs_lock);
+}
+
+static void fs_read_sectors(uint32_t lba, uint32_t count, uint8_t* buffer) {
+    // Sin selección explícita se usa el dispositivo por defecto
+    if (!fs_device) {
+        fs_device = blockdev_default();
+    }
+    blkq_read(fs_device, lba, count, buffer);
+}
+
+static void fs_write_sectors(uint32_t lba, uint32_t count, const uint8_t* buffer) {
+    if (!fs_device) {
+        fs_device = blockdev_default();
+    }
+    blkq_write(fs_device, lba, count, buffer);
+}
+
+// Fin de una operación: las escrituras encoladas salen ordenadas por sector
+static void fs_commit(void) {
+    if (fs_device) {
+        blkq_flush(fs_device);
+    }
+}
 
 static uint32_t simple_hash(const char* str) {
     uint32_t hash = 5381;
@@ -81,13 +116,13 @@ static void free_inode(uint32_t inode_num) {
 }
 
 static void sync_superblock(void) {
-    disk_write_sectors(FS_SUPERBLOCK_SECTOR, 1, (uint8_t*)&superblock);
+    fs_write_sectors(FS_SUPERBLOCK_SECTOR, 1, (uint8_t*)&superblock);
 }
 
 static void sync_inode_table(void) {
     uint32_t sectors_needed = (sizeof(inode_table) + 511) / 512;
     for (uint32_t i = 0; i < sectors_needed; i++) {
-        disk_write_sectors(FS_INODE_TABLE_SECTOR + i, 1, 
+        fs_write_sectors(FS_INODE_TABLE_SECTOR + i, 1, 
                           ((uint8_t*)inode_table) + (i * 512));
     }
 }
@@ -95,19 +130,19 @@ static void sync_inode_table(void) {
 static void sync_block_bitmap(void) {
     uint32_t sectors_needed = (sizeof(block_bitmap) + 511) / 512;
     for (uint32_t i = 0; i < sectors_needed; i++) {
-        disk_write_sectors(FS_BLOCK_BITMAP_SECTOR + i, 1, 
+        fs_write_sectors(FS_BLOCK_BITMAP_SECTOR + i, 1, 
                           ((uint8_t*)block_bitmap) + (i * 512));
     }
 }
 
 static void load_superblock(void) {
-    disk_read_sectors(FS_SUPERBLOCK_SECTOR, 1, (uint8_t*)&superblock);
+    fs_read_sectors(FS_SUPERBLOCK_SECTOR, 1, (uint8_t*)&superblock);
 }
 
 static void load_inode_table(void) {
     uint32_t sectors_needed = (sizeof(inode_table) + 511) / 512;
     for (uint32_t i = 0; i < sectors_needed; i++) {
-        disk_read_sectors(FS_INODE_TABLE_SECTOR + i, 1, 
+        fs_read_sectors(FS_INODE_TABLE_SECTOR + i, 1, 
                          ((uint8_t*)inode_table) + (i * 512));
     }
 }
@@ -115,7 +150,7 @@ static void load_inode_table(void) {
 static void load_block_bitmap(void) {
     uint32_t sectors_needed = (sizeof(block_bitmap) + 511) / 512;
     for (uint32_t i = 0; i < sectors_needed; i++) {
-        disk_read_sectors(FS_BLOCK_BITMAP_SECTOR + i, 1, 
+        fs_read_sectors(FS_BLOCK_BITMAP_SECTOR + i, 1, 
                          ((uint8_t*)block_bitmap) + (i * 512));
     }
 }
@@ -125,14 +160,14 @@ static void read_inode_block(uint32_t block_num, uint8_t* buffer) {
         memset(buffer, 0, 512);
         return;
     }
-    disk_read_sectors(FS_DATA_START_SECTOR + block_num, 1, buffer);
+    fs_read_sectors(FS_DATA_START_SECTOR + block_num, 1, buffer);
 }
 
 static void write_inode_block(uint32_t block_num, uint8_t* buffer) {
     if (block_num == 0 || block_num >= FS_MAX_BLOCKS) {
         return;
     }
-    disk_write_sectors(FS_DATA_START_SECTOR + block_num, 1, buffer);
+    fs_write_sectors(FS_DATA_START_SECTOR + block_num, 1, buffer);
 }
 
 static void normalize_path(const char* path, char* normalized) {
@@ -272,19 +307,24 @@ static uint32_t find_inode_by_path(const char* path) {
 }
 
 void fs_init(void) {
+    mutex_lock(&fs_lock);
     load_superblock();
     load_inode_table();
     load_block_bitmap();
+    mutex_unlock(&fs_lock);
 }
 
 int fs_check_installed(void) {
+    mutex_lock(&fs_lock);
     load_superblock();
-    return superblock.magic == FS_MAGIC && 
-           superblock.version == FS_VERSION && 
-           superblock.installed == 1;
+    int installed = superblock.magic == FS_MAGIC && 
+                    superblock.version == FS_VERSION && 
+                    superblock.installed == 1;
+    mutex_unlock(&fs_lock);
+    return installed;
 }
 
-void fs_format(void) {
+static void format_locked(void) {
     memset(&superblock, 0, sizeof(fs_superblock_t));
     memset(inode_table, 0, sizeof(inode_table));
     memset(block_bitmap, 0, sizeof(block_bitmap));
@@ -305,9 +345,10 @@ void fs_format(void) {
     sync_superblock();
     sync_inode_table();
     sync_block_bitmap();
+    fs_commit();
 }
 
-void fs_install(const char* hostname, const char* username, const char* password) {
+static void install_locked(const char* hostname, const char* username, const char* password) {
     memset(&superblock, 0, sizeof(fs_superblock_t));
     memset(inode_table, 0, sizeof(inode_table));
     memset(block_bitmap, 0, sizeof(block_bitmap));
@@ -365,43 +406,49 @@ void fs_install(const char* hostname, const char* username, const char* password
     sync_superblock();
     sync_inode_table();
     sync_block_bitmap();
+    fs_commit();
     
     load_superblock();
     load_inode_table();
     load_block_bitmap();
     
-    fs_create_dir("/bin");
-    fs_create_dir("/home");
-    fs_create_dir("/tmp");
-    fs_create_dir("/etc");
-    fs_create_dir("/var");
+    create_dir_locked("/bin");
+    create_dir_locked("/home");
+    create_dir_locked("/tmp");
+    create_dir_locked("/etc");
+    create_dir_locked("/var");
     
     char user_home[128];
     strcpy(user_home, "/home/");
     strcat(user_home, username);
-    fs_create_dir(user_home);
+    create_dir_locked(user_home);
     
     char user_docs[128];
     strcpy(user_docs, user_home);
     strcat(user_docs, "/documents");
-    fs_create_dir(user_docs);
+    create_dir_locked(user_docs);
     
     char user_downloads[128];
     strcpy(user_downloads, user_home);
     strcat(user_downloads, "/downloads");
-    fs_create_dir(user_downloads);
+    create_dir_locked(user_downloads);
     
     sync_superblock();
     sync_inode_table();
     sync_block_bitmap();
+    fs_commit();
 }
 
 void fs_get_hostname(char* buffer) {
+    mutex_lock(&fs_lock);
     strcpy(buffer, superblock.hostname);
+    mutex_unlock(&fs_lock);
 }
 
 void fs_get_username(char* buffer) {
+    mutex_lock(&fs_lock);
     strcpy(buffer, superblock.username);
+    mutex_unlock(&fs_lock);
 }
 
 int fs_verify_password(const char* password) {
@@ -410,10 +457,14 @@ int fs_verify_password(const char* password) {
     for (int i = 0; i < 32; i++) {
         hash_bytes[i] = (hash >> (i % 32)) & 0xFF;
     }
-    return memcmp(hash_bytes, superblock.password_hash, 32) == 0;
+    
+    mutex_lock(&fs_lock);
+    int match = memcmp(hash_bytes, superblock.password_hash, 32) == 0;
+    mutex_unlock(&fs_lock);
+    return match;
 }
 
-int fs_create_dir(const char* path) {
+static int create_dir_locked(const char* path) {
     char parent_path[256];
     char dir_name[FS_MAX_FILENAME];
     split_path(path, parent_path, dir_name);
@@ -431,7 +482,7 @@ int fs_create_dir(const char* path) {
     
     if (parent_inode == 0xFFFFFFFF) {
         if (strcmp(parent_path, "/") != 0) {
-            if (fs_create_dir(parent_path) != 0) {
+            if (create_dir_locked(parent_path) != 0) {
                 return -1;
             }
             parent_inode = find_inode_by_path(parent_path);
@@ -501,18 +552,19 @@ int fs_create_dir(const char* path) {
     
     sync_inode_table();
     sync_block_bitmap();
+    fs_commit();
     
     return 0;
 }
 
-int fs_dir_exists(const char* path) {
+static int dir_exists_locked(const char* path) {
     uint32_t inode = find_inode_by_path(path);
     if (inode == 0xFFFFFFFF) return 0;
     if (inode >= FS_MAX_INODES) return 0;
     return inode_table[inode].type == INODE_TYPE_DIR;
 }
 
-int fs_list_dir(const char* path, char* buffer, int max_size) {
+static int list_dir_locked(const char* path, char* buffer, int max_size) {
     uint32_t inode = find_inode_by_path(path);
     
     if (inode == 0xFFFFFFFF || inode >= FS_MAX_INODES) {
@@ -581,7 +633,7 @@ int fs_list_dir(const char* path, char* buffer, int max_size) {
     return written;
 }
 
-int fs_change_dir(const char* path, char* current_dir) {
+static int change_dir_locked(const char* path, char* current_dir) {
     if (strcmp(path, "..") == 0) {
         if (strcmp(current_dir, "/") == 0) {
             return 0;
@@ -614,7 +666,7 @@ int fs_change_dir(const char* path, char* current_dir) {
         }
     }
     
-    if (fs_dir_exists(new_path)) {
+    if (dir_exists_locked(new_path)) {
         strcpy(current_dir, new_path);
         return 0;
     }
@@ -622,7 +674,7 @@ int fs_change_dir(const char* path, char* current_dir) {
     return -1;
 }
 
-int fs_create_file(const char* path, const uint8_t* data, uint32_t size) {
+static int create_file_locked(const char* path, const uint8_t* data, uint32_t size) {
     if (size > FS_MAX_FILE_SIZE) return -1;
     
     char parent_path[256];
@@ -635,7 +687,7 @@ int fs_create_file(const char* path, const uint8_t* data, uint32_t size) {
     
     uint32_t parent_inode = find_inode_by_path(parent_path);
     if (parent_inode == 0xFFFFFFFF) {
-        if (fs_create_dir(parent_path) != 0) {
+        if (create_dir_locked(parent_path) != 0) {
             return -1;
         }
         parent_inode = find_inode_by_path(parent_path);
@@ -650,7 +702,7 @@ int fs_create_file(const char* path, const uint8_t* data, uint32_t size) {
     
     uint32_t existing = find_inode_by_path(path);
     if (existing != 0xFFFFFFFF) {
-        fs_delete_file(path);
+        delete_file_locked(path);
     }
     
     uint32_t new_inode = allocate_inode();
@@ -706,11 +758,12 @@ int fs_create_file(const char* path, const uint8_t* data, uint32_t size) {
     sync_inode_table();
     sync_block_bitmap();
     sync_superblock();
+    fs_commit();
     
     return 0;
 }
 
-int fs_read_file(const char* path, uint8_t* buffer, uint32_t max_size) {
+static int read_file_locked(const char* path, uint8_t* buffer, uint32_t max_size) {
     uint32_t inode = find_inode_by_path(path);
     if (inode == 0xFFFFFFFF || inode >= FS_MAX_INODES) {
         return -1;
@@ -739,7 +792,7 @@ int fs_read_file(const char* path, uint8_t* buffer, uint32_t max_size) {
     return inode_table[inode].size;
 }
 
-int fs_delete_file(const char* path) {
+static int delete_file_locked(const char* path) {
     char parent_path[256];
     char file_name[FS_MAX_FILENAME];
     split_path(path, parent_path, file_name);
@@ -771,13 +824,85 @@ int fs_delete_file(const char* path) {
     
     sync_inode_table();
     sync_block_bitmap();
+    fs_commit();
     
     return 0;
 }
 
-int fs_file_exists(const char* path) {
+static int file_exists_locked(const char* path) {
     uint32_t inode = find_inode_by_path(path);
     if (inode == 0xFFFFFFFF) return 0;
     if (inode >= FS_MAX_INODES) return 0;
     return inode_table[inode].type == INODE_TYPE_FILE;
 }
+
+// API pública: cada operación se ejecuta entera bajo fs_lock. Las funciones
+// *_locked se llaman entre sí sin volver a tomarlo
+
+void fs_format(void) {
+    mutex_lock(&fs_lock);
+    format_locked();
+    mutex_unlock(&fs_lock);
+}
+
+void fs_install(const char* hostname, const char* username, const char* password) {
+    mutex_lock(&fs_lock);
+    install_locked(hostname, username, password);
+    mutex_unlock(&fs_lock);
+}
+
+int fs_create_dir(const char* path) {
+    mutex_lock(&fs_lock);
+    int result = create_dir_locked(path);
+    mutex_unlock(&fs_lock);
+    return result;
+}
+
+int fs_dir_exists(const char* path) {
+    mutex_lock(&fs_lock);
+    int result = dir_exists_locked(path);
+    mutex_unlock(&fs_lock);
+    return result;
+}
+
+int fs_list_dir(const char* path, char* buffer, int max_size) {
+    mutex_lock(&fs_lock);
+    int result = list_dir_locked(path, buffer, max_size);
+    mutex_unlock(&fs_lock);
+    return result;
+}
+
+int fs_change_dir(const char* path, char* current_dir) {
+    mutex_lock(&fs_lock);
+    int result = change_dir_locked(path, current_dir);
+    mutex_unlock(&fs_lock);
+    return result;
+}
+
+int fs_create_file(const char* path, const uint8_t* data, uint32_t size) {
+    mutex_lock(&fs_lock);
+    int result = create_file_locked(path, data, size);
+    mutex_unlock(&fs_lock);
+    return result;
+}
+
+int fs_read_file(const char* path, uint8_t* buffer, uint32_t max_size) {
+    mutex_lock(&fs_lock);
+    int result = read_file_locked(path, buffer, max_size);
+    mutex_unlock(&fs_lock);
+    return result;
+}
+
+int fs_delete_file(const char* path) {
+    mutex_lock(&fs_lock);
+    int result = delete_file_locked(path);
+    mutex_unlock(&fs_lock);
+    return result;
+}
+
+int fs_file_exists(const char* path) {
+    mutex_lock(&fs_lock);
+    int result = file_exists_locked(path);
+    mutex_unlock(&fs_lock);
+    return result;
+}
@@ -3,6 +3,7 @@
 #define FILESYSTEM_H
 
 #include "../kernel/kernel.h"
+#include "../drivers/blockdev.h"
 
 #define FS_MAGIC 0x45504853
 #define FS_VERSION 2
@@ -56,6 +57,7 @@ typedef struct {
 } fs_dir_block_t;
 
 void fs_init(void);
+void fs_set_device(blockdev_t* dev);
 int fs_check_installed(void);
 void fs_install(const char* hostname, const char* username, const char* password);
 void fs_format(void);
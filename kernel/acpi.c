@@ -0,0 +1,68 @@
+// kernel/acpi.c
+#include "acpi.h"
+
+static const acpi_rsdp_t* rsdp = 0;
+static const acpi_sdt_header_t* rsdt = 0;
+
+static int acpi_checksum(const void* data, uint32_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint8_t sum = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        sum += bytes[i];
+    }
+    return sum == 0;
+}
+
+static const acpi_rsdp_t* acpi_scan(uint32_t start, uint32_t length) {
+    // El RSDP está alineado a 16 bytes
+    for (uint32_t addr = start; addr < start + length; addr += 16) {
+        const acpi_rsdp_t* candidate = (const acpi_rsdp_t*)addr;
+        if (memcmp(candidate->signature, "RSD PTR ", 8) == 0 &&
+            acpi_checksum(candidate, sizeof(acpi_rsdp_t))) {
+            return candidate;
+        }
+    }
+    return 0;
+}
+
+int acpi_init(void) {
+    // Primero el primer KB de la EBDA, después el área de la BIOS
+    uint32_t ebda = (uint32_t)(*(volatile uint16_t*)0x40E) << 4;
+    
+    rsdp = 0;
+    if (ebda) {
+        rsdp = acpi_scan(ebda, 1024);
+    }
+    if (!rsdp) {
+        rsdp = acpi_scan(0xE0000, 0x20000);
+    }
+    if (!rsdp) {
+        return 0;
+    }
+    
+    rsdt = (const acpi_sdt_header_t*)rsdp->rsdt_address;
+    if (memcmp(rsdt->signature, "RSDT", 4) != 0 || !acpi_checksum(rsdt, rsdt->length)) {
+        rsdt = 0;
+        return 0;
+    }
+    
+    return 1;
+}
+
+const acpi_sdt_header_t* acpi_find_table(const char* signature) {
+    if (!rsdt) {
+        return 0;
+    }
+    
+    uint32_t entries = (rsdt->length - sizeof(acpi_sdt_header_t)) / 4;
+    const uint32_t* pointers = (const uint32_t*)(rsdt + 1);
+    
+    for (uint32_t i = 0; i < entries; i++) {
+        const acpi_sdt_header_t* table = (const acpi_sdt_header_t*)pointers[i];
+        if (memcmp(table->signature, signature, 4) == 0 && acpi_checksum(table, table->length)) {
+            return table;
+        }
+    }
+    
+    return 0;
+}
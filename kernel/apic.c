@@ -0,0 +1,156 @@
+// kernel/apic.c
+#include "apic.h"
+#include "timer.h"
+
+static volatile uint32_t* lapic = 0;
+static volatile uint32_t* ioapic = 0;
+static uint32_t ioapic_gsi_base = 0;
+static uint32_t ioapic_entries = 0;
+static uint32_t lapic_timer_count = 0;
+
+// Redirecciones de IRQ ISA declaradas en la MADT
+static uint32_t irq_gsi[16];
+static uint16_t irq_flags[16];
+
+static inline uint32_t lapic_read(uint32_t reg) {
+    return lapic[reg / 4];
+}
+
+static inline void lapic_write(uint32_t reg, uint32_t value) {
+    lapic[reg / 4] = value;
+    (void)lapic[LAPIC_ID / 4];
+}
+
+static void udelay(uint32_t us) {
+    // Cada acceso al puerto 0x80 tarda aproximadamente un microsegundo
+    for (uint32_t i = 0; i < us; i++) {
+        asm volatile("outb %%al, $0x80" : : "a"(0));
+    }
+}
+
+void lapic_init(uint32_t base) {
+    lapic = (volatile uint32_t*)base;
+    
+    for (int i = 0; i < 16; i++) {
+        irq_gsi[i] = i;
+        irq_flags[i] = 0;
+    }
+}
+
+int lapic_available(void) {
+    return lapic != 0;
+}
+
+void lapic_enable(void) {
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | APIC_SPURIOUS_VECTOR);
+}
+
+uint8_t lapic_id(void) {
+    if (!lapic) {
+        return 0;
+    }
+    return lapic_read(LAPIC_ID) >> 24;
+}
+
+void lapic_eoi(void) {
+    lapic_write(LAPIC_EOI, 0);
+}
+
+static void lapic_send_ipi(uint8_t apic_id, uint32_t command) {
+    lapic_write(LAPIC_ICR_HIGH, (uint32_t)apic_id << 24);
+    lapic_write(LAPIC_ICR_LOW, command);
+    
+    while (lapic_read(LAPIC_ICR_LOW) & LAPIC_ICR_PENDING);
+}
+
+void lapic_send_init(uint8_t apic_id) {
+    lapic_send_ipi(apic_id, LAPIC_ICR_INIT | LAPIC_ICR_ASSERT);
+    udelay(10000);
+}
+
+void lapic_send_startup(uint8_t apic_id, uint8_t vector) {
+    lapic_send_ipi(apic_id, LAPIC_ICR_STARTUP | LAPIC_ICR_ASSERT | vector);
+    udelay(200);
+}
+
+// Mide cuántas cuentas del temporizador del APIC caben en un tick del PIT
+void lapic_timer_calibrate(void) {
+    lapic_write(LAPIC_TIMER_DIVIDE, 0x3);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_TIMER_MASKED);
+    
+    uint32_t start = timer_get_ticks();
+    while (timer_get_ticks() == start);
+    
+    lapic_write(LAPIC_TIMER_INIT, 0xFFFFFFFF);
+    start = timer_get_ticks();
+    while (timer_get_ticks() - start < 10);
+    
+    uint32_t elapsed = 0xFFFFFFFF - lapic_read(LAPIC_TIMER_CURRENT);
+    lapic_write(LAPIC_TIMER_INIT, 0);
+    
+    lapic_timer_count = elapsed / 10;
+}
+
+void lapic_timer_start(void) {
+    if (lapic_timer_count == 0) {
+        return;
+    }
+    
+    lapic_write(LAPIC_TIMER_DIVIDE, 0x3);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_TIMER_PERIODIC | APIC_TIMER_VECTOR);
+    lapic_write(LAPIC_TIMER_INIT, lapic_timer_count);
+}
+
+static uint32_t ioapic_read(uint8_t reg) {
+    ioapic[IOAPIC_REGSEL / 4] = reg;
+    return ioapic[IOAPIC_WINDOW / 4];
+}
+
+static void ioapic_write(uint8_t reg, uint32_t value) {
+    ioapic[IOAPIC_REGSEL / 4] = reg;
+    ioapic[IOAPIC_WINDOW / 4] = value;
+}
+
+void ioapic_init(uint32_t base, uint32_t gsi_base) {
+    ioapic = (volatile uint32_t*)base;
+    ioapic_gsi_base = gsi_base;
+    ioapic_entries = ((ioapic_read(IOAPIC_VER) >> 16) & 0xFF) + 1;
+    
+    // Las IRQ heredadas siguen llegando por el PIC; todas las entradas empiezan enmascaradas
+    for (uint32_t i = 0; i < ioapic_entries; i++) {
+        ioapic_write(IOAPIC_REDTBL + i * 2, 0x10000);
+        ioapic_write(IOAPIC_REDTBL + i * 2 + 1, 0);
+    }
+}
+
+void ioapic_set_override(uint8_t irq, uint32_t gsi, uint16_t flags) {
+    if (irq < 16) {
+        irq_gsi[irq] = gsi;
+        irq_flags[irq] = flags;
+    }
+}
+
+void ioapic_route_irq(uint8_t irq, uint8_t vector, uint8_t apic_id) {
+    if (!ioapic || irq >= 16) {
+        return;
+    }
+    
+    uint32_t gsi = irq_gsi[irq];
+    if (gsi < ioapic_gsi_base || gsi - ioapic_gsi_base >= ioapic_entries) {
+        return;
+    }
+    
+    uint32_t index = gsi - ioapic_gsi_base;
+    uint32_t low = vector;
+    
+    // Polaridad (bits 0-1) y disparo (bits 2-3) de la redirección de la MADT
+    if ((irq_flags[irq] & 0x3) == 0x3) {
+        low |= 1 << 13;
+    }
+    if (((irq_flags[irq] >> 2) & 0x3) == 0x3) {
+        low |= 1 << 15;
+    }
+    
+    ioapic_write(IOAPIC_REDTBL + index * 2 + 1, (uint32_t)apic_id << 24);
+    ioapic_write(IOAPIC_REDTBL + index * 2, low);
+}
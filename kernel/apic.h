@@ -0,0 +1,53 @@
+// kernel/apic.h
+#ifndef APIC_H
+#define APIC_H
+
+#include "kernel.h"
+
+#define LAPIC_DEFAULT_BASE 0xFEE00000
+
+// Registros del APIC local
+#define LAPIC_ID        0x020
+#define LAPIC_EOI       0x0B0
+#define LAPIC_SVR       0x0F0
+#define LAPIC_ICR_LOW   0x300
+#define LAPIC_ICR_HIGH  0x310
+#define LAPIC_LVT_TIMER 0x320
+#define LAPIC_TIMER_INIT    0x380
+#define LAPIC_TIMER_CURRENT 0x390
+#define LAPIC_TIMER_DIVIDE  0x3E0
+
+#define LAPIC_SVR_ENABLE 0x100
+#define LAPIC_TIMER_PERIODIC 0x20000
+#define LAPIC_TIMER_MASKED   0x10000
+
+#define LAPIC_ICR_INIT    0x500
+#define LAPIC_ICR_STARTUP 0x600
+#define LAPIC_ICR_PENDING 0x1000
+#define LAPIC_ICR_ASSERT  0x4000
+
+// Vectores de interrupción propios del APIC (por encima de los del PIC)
+#define APIC_TIMER_VECTOR    0x30
+#define APIC_SPURIOUS_VECTOR 0xFF
+
+// Registros del IOAPIC
+#define IOAPIC_REGSEL 0x00
+#define IOAPIC_WINDOW 0x10
+#define IOAPIC_VER    0x01
+#define IOAPIC_REDTBL 0x10
+
+void lapic_init(uint32_t base);
+void lapic_enable(void);
+int lapic_available(void);
+uint8_t lapic_id(void);
+void lapic_eoi(void);
+void lapic_send_init(uint8_t apic_id);
+void lapic_send_startup(uint8_t apic_id, uint8_t vector);
+void lapic_timer_calibrate(void);
+void lapic_timer_start(void);
+
+void ioapic_init(uint32_t base, uint32_t gsi_base);
+void ioapic_route_irq(uint8_t irq, uint8_t vector, uint8_t apic_id);
+void ioapic_set_override(uint8_t irq, uint32_t gsi, uint16_t flags);
+
+#endif
@@ -0,0 +1,62 @@
+// kernel/atomic.h
+#ifndef ATOMIC_H
+#define ATOMIC_H
+
+#include "kernel.h"
+
+// En x86 las operaciones con prefijo lock ya son barreras completas
+typedef struct {
+    volatile int32_t value;
+} atomic_t;
+
+#define ATOMIC_INIT(v) { (v) }
+
+static inline int32_t atomic_read(const atomic_t* a) {
+    return __atomic_load_n(&a->value, __ATOMIC_ACQUIRE);
+}
+
+static inline void atomic_set(atomic_t* a, int32_t value) {
+    __atomic_store_n(&a->value, value, __ATOMIC_RELEASE);
+}
+
+// Devuelve el valor anterior
+static inline int32_t atomic_fetch_add(atomic_t* a, int32_t delta) {
+    return __atomic_fetch_add(&a->value, delta, __ATOMIC_SEQ_CST);
+}
+
+// Devuelven el valor nuevo
+static inline int32_t atomic_add(atomic_t* a, int32_t delta) {
+    return __atomic_add_fetch(&a->value, delta, __ATOMIC_SEQ_CST);
+}
+
+static inline int32_t atomic_inc(atomic_t* a) {
+    return atomic_add(a, 1);
+}
+
+static inline int32_t atomic_dec(atomic_t* a) {
+    return atomic_add(a, -1);
+}
+
+static inline int32_t atomic_xchg(atomic_t* a, int32_t value) {
+    return __atomic_exchange_n(&a->value, value, __ATOMIC_SEQ_CST);
+}
+
+// 1 si el valor era expected y se sustituyó por desired
+static inline int atomic_cmpxchg(atomic_t* a, int32_t expected, int32_t desired) {
+    return __atomic_compare_exchange_n(&a->value, &expected, desired, 0,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline void cpu_relax(void) {
+    asm volatile("pause" : : : "memory");
+}
+
+static inline void compiler_barrier(void) {
+    asm volatile("" : : : "memory");
+}
+
+static inline void memory_barrier(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif
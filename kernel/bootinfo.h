@@ -0,0 +1,50 @@
+// kernel/bootinfo.h
+#ifndef BOOTINFO_H
+#define BOOTINFO_H
+
+#include "kernel.h"
+
+// stage2.asm rellena esta estructura en modo real y pasa su dirección en EBX
+#define BOOT_INFO_ADDR  0x5000
+#define BOOT_INFO_MAGIC 0x544F4F42  // "BOOT"
+
+#define E820_MAX_ENTRIES 32
+
+#define E820_USABLE       1
+#define E820_RESERVED     2
+#define E820_ACPI_RECLAIM 3
+#define E820_ACPI_NVS     4
+#define E820_BAD          5
+
+// Marcas de TSC del arranque: stage1 y stage2 las escriben en boot_info
+#define BOOT_STAGE_STAGE1 0
+#define BOOT_STAGE_STAGE2 1
+#define BOOT_STAGE_KERNEL 2
+#define BOOT_STAGE_READY  3
+#define BOOT_STAGE_COUNT  4
+
+typedef struct {
+    uint64_t base;
+    uint64_t length;
+    uint32_t type;
+    uint32_t acpi_attributes;
+} __attribute__((packed)) e820_entry_t;
+
+typedef struct boot_info {
+    uint32_t magic;
+    uint32_t e820_count;
+    e820_entry_t e820[E820_MAX_ENTRIES];
+    uint64_t boot_tsc[BOOT_STAGE_COUNT];
+    
+    // Framebuffer VBE lineal de 32 bpp; fb_addr = 0 si se quedó en modo texto
+    uint32_t fb_addr;
+    uint32_t fb_pitch;
+    uint16_t fb_width;
+    uint16_t fb_height;
+    uint8_t fb_bpp;
+    uint8_t font_height;
+    uint16_t reserved;
+    uint32_t font_addr;     // fuente de 256 caracteres de 8 píxeles de ancho
+} __attribute__((packed)) boot_info_t;
+
+#endif
@@ -0,0 +1,92 @@
+// kernel/boottime.c
+#include "boottime.h"
+#include "cpu.h"
+#include "timer.h"
+#include "kprintf.h"
+#include "../drivers/screen.h"
+
+static const char* stage_names[BOOT_STAGE_COUNT] = {"stage1", "stage2", "kernel", "ready"};
+
+static uint64_t stamps[BOOT_STAGE_COUNT];
+
+// Referencia TSC/ticks para convertir ciclos en milisegundos sin calibrar aparte
+static uint64_t sync_tsc = 0;
+static uint32_t sync_ticks = 0;
+static uint32_t cycles_per_ms = 0;
+
+// División 64/32 sin libgcc: dos divl encadenadas
+static uint64_t div64(uint64_t n, uint32_t d) {
+    uint32_t high = (uint32_t)(n >> 32);
+    uint32_t low = (uint32_t)n;
+    uint32_t q_high = high / d;
+    uint32_t rem = high % d;
+    uint32_t q_low;
+    asm("divl %4" : "=a"(q_low), "=d"(rem) : "a"(low), "d"(rem), "rm"(d));
+    return ((uint64_t)q_high << 32) | q_low;
+}
+
+// stage1 ya usa rdtsc, así que cualquier CPU que llegue aquí tiene TSC
+void boottime_init(const boot_info_t* info) {
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        stamps[i] = 0;
+    }
+    
+    if (info && info->magic == BOOT_INFO_MAGIC) {
+        stamps[BOOT_STAGE_STAGE1] = info->boot_tsc[BOOT_STAGE_STAGE1];
+        stamps[BOOT_STAGE_STAGE2] = info->boot_tsc[BOOT_STAGE_STAGE2];
+    }
+    
+    stamps[BOOT_STAGE_KERNEL] = cpu_read_tsc();
+}
+
+void boottime_sync_timer(void) {
+    sync_ticks = timer_get_ticks();
+    sync_tsc = cpu_read_tsc();
+}
+
+void boottime_mark(int stage) {
+    if (stage < 0 || stage >= BOOT_STAGE_COUNT) {
+        return;
+    }
+    
+    stamps[stage] = cpu_read_tsc();
+    
+    // Con al menos 100 ms desde la referencia la frecuencia del TSC es fiable
+    uint32_t ticks = timer_get_ticks() - sync_ticks;
+    if (sync_tsc && ticks >= TIMER_HZ / 10) {
+        uint32_t ms = ticks * (1000 / TIMER_HZ);
+        cycles_per_ms = (uint32_t)div64(stamps[stage] - sync_tsc, ms);
+    }
+}
+
+void boottime_report(void) {
+    screen_print("[BOOT]");
+    
+    int prev = -1;
+    uint64_t total = 0;
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        if (!stamps[i]) {
+            continue;
+        }
+        
+        // Sin marca previa válida (p. ej. otro cargador) solo se puede medir desde aquí
+        if (prev >= 0 && stamps[i] > stamps[prev]) {
+            uint64_t cycles = stamps[i] - stamps[prev];
+            total += cycles;
+            
+            if (cycles_per_ms) {
+                kprintf(" %s->%s %u ms", stage_names[prev], stage_names[i],
+                        (uint32_t)div64(cycles, cycles_per_ms));
+            } else {
+                kprintf(" %s->%s %uK cycles", stage_names[prev], stage_names[i],
+                        (uint32_t)div64(cycles, 1000));
+            }
+        }
+        prev = i;
+    }
+    
+    if (cycles_per_ms && total) {
+        kprintf(" (total %u ms)", (uint32_t)div64(total, cycles_per_ms));
+    }
+    screen_print("\n");
+}
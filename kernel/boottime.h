@@ -0,0 +1,13 @@
+// kernel/boottime.h
+#ifndef BOOTTIME_H
+#define BOOTTIME_H
+
+#include "kernel.h"
+#include "bootinfo.h"
+
+void boottime_init(const boot_info_t* info);
+void boottime_sync_timer(void);
+void boottime_mark(int stage);
+void boottime_report(void);
+
+#endif
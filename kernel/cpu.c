@@ -0,0 +1,95 @@
+// kernel/cpu.c
+#include "cpu.h"
+
+static cpu_info_t cpu_info;
+static int sse_enabled = 0;
+
+void cpuid(uint32_t leaf, uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx) {
+    asm volatile("cpuid"
+                 : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                 : "a"(leaf), "c"(0));
+}
+
+static int cpuid_supported(void) {
+    uint32_t before, after;
+    
+    // CPUID existe si el bit ID (21) de EFLAGS se puede modificar
+    asm volatile("pushfl\n\t"
+                 "pop %0\n\t"
+                 "mov %0, %1\n\t"
+                 "xor $0x200000, %1\n\t"
+                 "push %1\n\t"
+                 "popfl\n\t"
+                 "pushfl\n\t"
+                 "pop %1\n\t"
+                 "push %0\n\t"
+                 "popfl"
+                 : "=&r"(before), "=&r"(after));
+                 
+    return ((before ^ after) & 0x200000) != 0;
+}
+
+static void enable_sse(void) {
+    uint32_t cr0, cr4;
+    
+    asm volatile("mov %%cr0, %0" : "=r"(cr0));
+    cr0 &= ~(1 << 2);   // EM: sin emulación de FPU
+    cr0 |= (1 << 1);    // MP
+    asm volatile("mov %0, %%cr0" : : "r"(cr0));
+    
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= (1 << 9) | (1 << 10);   // OSFXSR | OSXMMEXCPT
+    asm volatile("mov %0, %%cr4" : : "r"(cr4));
+    
+    asm volatile("fninit");
+    sse_enabled = 1;
+}
+
+void cpu_init(void) {
+    memset(&cpu_info, 0, sizeof(cpu_info));
+    
+    cpu_info.has_cpuid = cpuid_supported();
+    if (!cpu_info.has_cpuid) {
+        return;
+    }
+    
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(0, &eax, &ebx, &ecx, &edx);
+    cpu_info.max_leaf = eax;
+    memcpy(cpu_info.vendor, &ebx, 4);
+    memcpy(cpu_info.vendor + 4, &edx, 4);
+    memcpy(cpu_info.vendor + 8, &ecx, 4);
+    cpu_info.vendor[12] = '\0';
+    
+    if (cpu_info.max_leaf >= 1) {
+        cpuid(1, &eax, &ebx, &ecx, &edx);
+        cpu_info.features_edx = edx;
+        cpu_info.features_ecx = ecx;
+    }
+    
+    uint32_t sse_bits = CPUID_EDX_FXSR | CPUID_EDX_SSE | CPUID_EDX_SSE2;
+    if ((cpu_info.features_edx & sse_bits) == sse_bits) {
+        enable_sse();
+    }
+}
+
+// Los procesadores secundarios repiten la configuración de CR0/CR4 del BSP
+void cpu_init_ap(void) {
+    if (sse_enabled) {
+        enable_sse();
+    } else {
+        asm volatile("fninit");
+    }
+}
+
+const cpu_info_t* cpu_get_info(void) {
+    return &cpu_info;
+}
+
+int cpu_has_feature(uint32_t edx_bit) {
+    return (cpu_info.features_edx & edx_bit) != 0;
+}
+
+int cpu_sse_enabled(void) {
+    return sse_enabled;
+}
@@ -0,0 +1,49 @@
+// kernel/cpu.h
+#ifndef CPU_H
+#define CPU_H
+
+#include "kernel.h"
+
+// CPUID leaf 1, EDX
+#define CPUID_EDX_FPU   (1 << 0)
+#define CPUID_EDX_PSE   (1 << 3)
+#define CPUID_EDX_TSC   (1 << 4)
+#define CPUID_EDX_APIC  (1 << 9)
+#define CPUID_EDX_PGE   (1 << 13)
+#define CPUID_EDX_PAT   (1 << 16)
+#define CPUID_EDX_FXSR  (1 << 24)
+#define CPUID_EDX_SSE   (1 << 25)
+#define CPUID_EDX_SSE2  (1 << 26)
+
+typedef struct {
+    int has_cpuid;
+    uint32_t max_leaf;
+    uint32_t features_edx;
+    uint32_t features_ecx;
+    char vendor[13];
+} cpu_info_t;
+
+void cpu_init(void);
+void cpu_init_ap(void);
+const cpu_info_t* cpu_get_info(void);
+int cpu_has_feature(uint32_t edx_bit);
+int cpu_sse_enabled(void);
+void cpuid(uint32_t leaf, uint32_t* eax, uint32_t* ebx, uint32_t* ecx, uint32_t* edx);
+
+static inline uint64_t cpu_read_msr(uint32_t msr) {
+    uint32_t low, high;
+    asm volatile("rdmsr" : "=a"(low), "=d"(high) : "c"(msr));
+    return ((uint64_t)high << 32) | low;
+}
+
+static inline uint64_t cpu_read_tsc(void) {
+    uint32_t low, high;
+    asm volatile("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+}
+
+static inline void cpu_write_msr(uint32_t msr, uint64_t value) {
+    asm volatile("wrmsr" : : "c"(msr), "a"((uint32_t)value), "d"((uint32_t)(value >> 32)));
+}
+
+#endif
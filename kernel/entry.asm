@@ -3,6 +3,8 @@
 section .text
 global _start
 extern _kernel_main
+extern __bss_start
+extern __bss_end
 
 _start:
     ; Configurar segmentos
@@ -14,7 +16,16 @@ _start:
     mov ss, ax
     mov esp, 0x90000
 
-    ; Llamar al kernel en C
+    ; kernel.bin no incluye .bss: ponerla a cero (EBX = boot_info se conserva)
+    cld
+    xor eax, eax
+    mov edi, __bss_start
+    mov ecx, __bss_end
+    sub ecx, edi
+    rep stosb
+
+    ; Llamar al kernel en C con el boot_info de stage2
+    push ebx
     call _kernel_main
 
     ; Si kernel_main retorna, halt
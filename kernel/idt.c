@@ -0,0 +1,200 @@
+// kernel/idt.c
+#include "idt.h"
+#include "apic.h"
+#include "kprintf.h"
+#include "../drivers/screen.h"
+
+#define PIC1_COMMAND 0x20
+#define PIC1_DATA    0x21
+#define PIC2_COMMAND 0xA0
+#define PIC2_DATA    0xA1
+#define PIC_EOI      0x20
+#define PIC_READ_ISR 0x0B
+
+#define IDT_GATE_INTERRUPT 0x8E
+
+typedef struct {
+    uint16_t offset_low;
+    uint16_t selector;
+    uint8_t zero;
+    uint8_t flags;
+    uint16_t offset_high;
+} __attribute__((packed)) idt_entry_t;
+
+typedef struct {
+    uint16_t limit;
+    uint32_t base;
+} __attribute__((packed)) idt_pointer_t;
+
+static idt_entry_t idt[IDT_ENTRIES];
+static idt_pointer_t idt_pointer;
+static irq_handler_t irq_handlers[IRQ_COUNT];
+static irq_handler_t vector_handlers[IDT_ENTRIES];
+
+// Stubs de interrupts.asm: 32 excepciones seguidas de las 16 IRQ
+extern uint32_t isr_stub_table[];
+// Temporizador y vector espurio del APIC local
+extern uint32_t isr_apic_stub_table[];
+extern void idt_load(idt_pointer_t* pointer);
+
+static const char* exception_names[] = {
+    "Divide error", "Debug", "NMI", "Breakpoint", "Overflow", "Bound range",
+    "Invalid opcode", "Device not available", "Double fault", "Coprocessor overrun",
+    "Invalid TSS", "Segment not present", "Stack fault", "General protection",
+    "Page fault", "Reserved", "x87 FPU error", "Alignment check", "Machine check",
+    "SIMD exception"
+};
+
+static inline void outb(uint16_t port, uint8_t value) {
+    asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint8_t inb(uint16_t port) {
+    uint8_t ret;
+    asm volatile("inb %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+static void io_wait(void) {
+    outb(0x80, 0);
+}
+
+static void pic_remap(void) {
+    // ICW1-ICW4: vectores 0x20-0x2F, esclavo en IRQ2, modo 8086
+    outb(PIC1_COMMAND, 0x11);
+    io_wait();
+    outb(PIC2_COMMAND, 0x11);
+    io_wait();
+    outb(PIC1_DATA, IRQ_BASE);
+    io_wait();
+    outb(PIC2_DATA, IRQ_BASE + 8);
+    io_wait();
+    outb(PIC1_DATA, 0x04);
+    io_wait();
+    outb(PIC2_DATA, 0x02);
+    io_wait();
+    outb(PIC1_DATA, 0x01);
+    io_wait();
+    outb(PIC2_DATA, 0x01);
+    io_wait();
+    
+    // Todo enmascarado salvo la cascada; cada driver desenmascara su línea
+    outb(PIC1_DATA, ~(1 << IRQ_CASCADE) & 0xFF);
+    outb(PIC2_DATA, 0xFF);
+}
+
+void irq_mask(uint8_t irq) {
+    uint16_t port = irq < 8 ? PIC1_DATA : PIC2_DATA;
+    outb(port, inb(port) | (1 << (irq & 7)));
+}
+
+void irq_unmask(uint8_t irq) {
+    uint16_t port = irq < 8 ? PIC1_DATA : PIC2_DATA;
+    outb(port, inb(port) & ~(1 << (irq & 7)));
+}
+
+void irq_register_handler(uint8_t irq, irq_handler_t handler) {
+    if (irq >= IRQ_COUNT) {
+        return;
+    }
+    irq_handlers[irq] = handler;
+}
+
+void irq_register_vector(uint8_t vector, irq_handler_t handler) {
+    if (vector < IRQ_BASE + IRQ_COUNT) {
+        return;
+    }
+    vector_handlers[vector] = handler;
+}
+
+void idt_set_gate(uint8_t vector, uint32_t handler, uint8_t flags) {
+    idt[vector].offset_low = handler & 0xFFFF;
+    idt[vector].selector = 0x08;
+    idt[vector].zero = 0;
+    idt[vector].flags = flags;
+    idt[vector].offset_high = (handler >> 16) & 0xFFFF;
+}
+
+void idt_init(void) {
+    memset(idt, 0, sizeof(idt));
+    memset(irq_handlers, 0, sizeof(irq_handlers));
+    memset(vector_handlers, 0, sizeof(vector_handlers));
+    
+    for (int i = 0; i < 32 + IRQ_COUNT; i++) {
+        idt_set_gate(i, isr_stub_table[i], IDT_GATE_INTERRUPT);
+    }
+    idt_set_gate(APIC_TIMER_VECTOR, isr_apic_stub_table[0], IDT_GATE_INTERRUPT);
+    idt_set_gate(APIC_SPURIOUS_VECTOR, isr_apic_stub_table[1], IDT_GATE_INTERRUPT);
+    
+    pic_remap();
+    
+    idt_pointer.limit = sizeof(idt) - 1;
+    idt_pointer.base = (uint32_t)idt;
+    idt_install();
+}
+
+// Todos los procesadores comparten la misma IDT
+void idt_install(void) {
+    idt_load(&idt_pointer);
+}
+
+static void exception_handler(interrupt_frame_t* frame) {
+    screen_set_color(0x0C, 0x00);
+    screen_print("\nKERNEL PANIC: ");
+    if (frame->int_no < sizeof(exception_names) / sizeof(exception_names[0])) {
+        screen_print(exception_names[frame->int_no]);
+    } else {
+        kprintf("Exception 0x%08X", frame->int_no);
+    }
+    kprintf("\n  EIP=0x%08X ERR=0x%08X", frame->eip, frame->err_code);
+    if (frame->int_no == 14) {
+        uint32_t cr2;
+        asm volatile("mov %%cr2, %0" : "=r"(cr2));
+        kprintf(" CR2=0x%08X", cr2);
+    }
+    screen_print("\n");
+    
+    for (;;) {
+        asm volatile("cli; hlt");
+    }
+}
+
+// Punto de entrada común desde interrupts.asm
+void isr_dispatch(interrupt_frame_t* frame) {
+    if (frame->int_no < 32) {
+        exception_handler(frame);
+        return;
+    }
+    
+    // El vector espurio del APIC no tiene manejador y no lleva EOI
+    if (frame->int_no >= IRQ_BASE + IRQ_COUNT) {
+        if (vector_handlers[frame->int_no]) {
+            vector_handlers[frame->int_no](frame);
+        }
+        return;
+    }
+    
+    uint8_t irq = frame->int_no - IRQ_BASE;
+    
+    // IRQ espurias: el bit no aparece en el ISR del PIC y no llevan EOI
+    if (irq == 7 || irq == 15) {
+        uint16_t command = irq == 7 ? PIC1_COMMAND : PIC2_COMMAND;
+        outb(command, PIC_READ_ISR);
+        if (!(inb(command) & 0x80)) {
+            if (irq == 15) {
+                outb(PIC1_COMMAND, PIC_EOI);
+            }
+            return;
+        }
+    }
+    
+    // El EOI va antes del manejador porque éste puede cambiar de hilo
+    if (irq >= 8) {
+        outb(PIC2_COMMAND, PIC_EOI);
+    }
+    outb(PIC1_COMMAND, PIC_EOI);
+    
+    if (irq_handlers[irq]) {
+        irq_handlers[irq](frame);
+    }
+}
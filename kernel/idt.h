@@ -0,0 +1,57 @@
+// kernel/idt.h
+#ifndef IDT_H
+#define IDT_H
+
+#include "kernel.h"
+
+#define IDT_ENTRIES 256
+#define IRQ_BASE 0x20
+#define IRQ_COUNT 16
+
+#define IRQ_TIMER 0
+#define IRQ_KEYBOARD 1
+#define IRQ_CASCADE 2
+
+// Registros que guarda interrupts.asm, en el orden en que quedan en la pila
+typedef struct {
+    uint32_t gs, fs, es, ds;
+    uint32_t edi, esi, ebp, esp_dummy, ebx, edx, ecx, eax;
+    uint32_t int_no, err_code;
+    uint32_t eip, cs, eflags;
+} __attribute__((packed)) interrupt_frame_t;
+
+typedef void (*irq_handler_t)(interrupt_frame_t* frame);
+
+void idt_init(void);
+void idt_set_gate(uint8_t vector, uint32_t handler, uint8_t flags);
+
+void idt_install(void);
+
+void irq_register_handler(uint8_t irq, irq_handler_t handler);
+// Vectores que no vienen del PIC (APIC local); el manejador envía su propio EOI
+void irq_register_vector(uint8_t vector, irq_handler_t handler);
+void irq_mask(uint8_t irq);
+void irq_unmask(uint8_t irq);
+
+static inline void interrupts_enable(void) {
+    asm volatile("sti" : : : "memory");
+}
+
+static inline void interrupts_disable(void) {
+    asm volatile("cli" : : : "memory");
+}
+
+// Desactiva interrupciones y devuelve EFLAGS para restaurarlas después
+static inline uint32_t irq_save(void) {
+    uint32_t flags;
+    asm volatile("pushf; pop %0; cli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+static inline void irq_restore(uint32_t flags) {
+    if (flags & 0x200) {
+        asm volatile("sti" : : : "memory");
+    }
+}
+
+#endif
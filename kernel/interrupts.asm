@@ -0,0 +1,132 @@
+; kernel/interrupts.asm
+; Stubs de excepciones e IRQ que llaman a isr_dispatch en C
+
+[BITS 32]
+
+section .text
+global _idt_load
+global _isr_stub_table
+global _isr_apic_stub_table
+extern _isr_dispatch
+
+_idt_load:
+    mov eax, [esp + 4]
+    lidt [eax]
+    ret
+
+; Excepciones sin código de error: se apila un 0 para uniformar el marco
+%macro ISR_NOERR 1
+isr%1:
+    push dword 0
+    push dword %1
+    jmp isr_common
+%endmacro
+
+%macro ISR_ERR 1
+isr%1:
+    push dword %1
+    jmp isr_common
+%endmacro
+
+%macro IRQ 1
+irq%1:
+    push dword 0
+    push dword 32 + %1
+    jmp isr_common
+%endmacro
+
+ISR_NOERR 0
+ISR_NOERR 1
+ISR_NOERR 2
+ISR_NOERR 3
+ISR_NOERR 4
+ISR_NOERR 5
+ISR_NOERR 6
+ISR_NOERR 7
+ISR_ERR   8
+ISR_NOERR 9
+ISR_ERR   10
+ISR_ERR   11
+ISR_ERR   12
+ISR_ERR   13
+ISR_ERR   14
+ISR_NOERR 15
+ISR_NOERR 16
+ISR_ERR   17
+ISR_NOERR 18
+ISR_NOERR 19
+ISR_NOERR 20
+ISR_ERR   21
+ISR_NOERR 22
+ISR_NOERR 23
+ISR_NOERR 24
+ISR_NOERR 25
+ISR_NOERR 26
+ISR_NOERR 27
+ISR_NOERR 28
+ISR_ERR   29
+ISR_ERR   30
+ISR_NOERR 31
+
+IRQ 0
+IRQ 1
+IRQ 2
+IRQ 3
+IRQ 4
+IRQ 5
+IRQ 6
+IRQ 7
+IRQ 8
+IRQ 9
+IRQ 10
+IRQ 11
+IRQ 12
+IRQ 13
+IRQ 14
+IRQ 15
+
+; Vectores del APIC local: temporizador (0x30) y espurio (0xFF)
+ISR_NOERR 48
+ISR_NOERR 255
+
+isr_common:
+    pusha
+    push ds
+    push es
+    push fs
+    push gs
+
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+
+    push esp
+    cld
+    call _isr_dispatch
+    add esp, 4
+
+    pop gs
+    pop fs
+    pop es
+    pop ds
+    popa
+    add esp, 8
+    iret
+
+section .data
+_isr_stub_table:
+%assign i 0
+%rep 32
+    dd isr%+i
+%assign i i+1
+%endrep
+%assign i 0
+%rep 16
+    dd irq%+i
+%assign i i+1
+%endrep
+_isr_apic_stub_table:
+    dd isr48
+    dd isr255
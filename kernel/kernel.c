@@ -1,8 +1,20 @@
 // kernel/kernel.c
 #include "kernel.h"
+#include "cpu.h"
+#include "idt.h"
+#include "memory.h"
+#include "paging.h"
+#include "memmap.h"
+#include "boottime.h"
+#include "timer.h"
+#include "thread.h"
+#include "acpi.h"
+#include "smp.h"
+#include "kprintf.h"
 #include "../drivers/screen.h"
+#include "../drivers/serial.h"
 #include "../drivers/keyboard.h"
-#include "../drivers/disk.h"
+#include "../drivers/blockdev.h"
 #include "../drivers/rtc.h"
 #include "../drivers/network.h"
 #include "../drivers/pci.h"
@@ -16,6 +28,7 @@
 #include "../net/udp.h"
 #include "../net/dns.h"
 #include "../net/ntp.h"
+#include "../net/checksum.h"
 
 static void keyboard_getline_password(char* buffer, int max_length) {
     int index = 0;
@@ -44,46 +57,36 @@ static void keyboard_getline_password(char* buffer, int max_length) {
     }
 }
 
+static void net_rx_thread(void* arg) {
+    (void)arg;
+    
+    // Atiende ARP, ICMP y los sockets UDP aunque ningún comando esté esperando
+    for (;;) {
+        eth_poll();
+        thread_sleep(10);
+    }
+}
+
 static void shutdown_system(void) {
     screen_print("\nShutting down...\n");
     for (volatile int i = 0; i < 50000000; i++);
 
-    asm volatile("mov $0x2000, %ax; mov %ax, %dx; out %ax, %dx");
-    asm volatile("mov $0x5307, %ax; mov $0x0001, %bx; mov $0x0003, %cx; int $0x15");
+    // Puertos ACPI de QEMU (PIIX4) y Bochs; la APM de la BIOS no es accesible en modo protegido
+    asm volatile("outw %0, %1" : : "a"((uint16_t)0x2000), "Nd"((uint16_t)0x604));
+    asm volatile("outw %0, %1" : : "a"((uint16_t)0x2000), "Nd"((uint16_t)0xB004));
 
     while(1) {
         asm volatile("hlt");
     }
 }
 
-static uint8_t read_keyboard_direct(void) {
-    while (1) {
-        uint8_t status;
-        asm volatile("inb $0x64, %0" : "=a"(status));
-        if (status & 0x01) {
-            uint8_t scancode;
-            asm volatile("inb $0x60, %0" : "=a"(scancode));
-            return scancode;
-        }
-    }
-}
-
 static int show_continue_menu(void) {
     int selected = 0;
     int screen_row = 20;
     
-    for (volatile int d = 0; d < 10000000; d++);
-    
-    for (int i = 0; i < 100; i++) {
-        uint8_t status;
-        asm volatile("inb $0x64, %0" : "=a"(status));
-        if (status & 0x01) {
-            uint8_t dummy;
-            asm volatile("inb $0x60, %0" : "=a"(dummy));
-        }
-        for (volatile int j = 0; j < 10000; j++);
-    }
-    
+    // Descartar las teclas que quedaron de la instalación
+    keyboard_flush();
+
     screen_set_row(screen_row);
     screen_set_color(0x0F, 0x00);
     screen_print("                                          ");
@@ -123,29 +126,18 @@ static int show_continue_menu(void) {
             screen_print("    No  ");
         }
         
-        uint8_t scancode = read_keyboard_direct();
+        key_event_t event;
+        keyboard_get_event(&event);
         
-        if (scancode & 0x80) {
+        if (event.flags & KEY_FLAG_RELEASED) {
             continue;
         }
         
-        if (scancode == 0x4B) {
+        if (event.scancode == KEY_LEFT || event.scancode == KEY_UP) {
             selected = 0;
-            for (volatile int i = 0; i < 500000; i++);
-        } else if (scancode == 0x4D) {
+        } else if (event.scancode == KEY_RIGHT || event.scancode == KEY_DOWN) {
             selected = 1;
-            for (volatile int i = 0; i < 500000; i++);
-        } else if (scancode == 0x48) {
-            selected = 0;
-            for (volatile int i = 0; i < 500000; i++);
-        } else if (scancode == 0x50) {
-            selected = 1;
-            for (volatile int i = 0; i < 500000; i++);
-        } else if (scancode == 0x1C) {
-            while (1) {
-                scancode = read_keyboard_direct();
-                if (scancode == 0x9C) break;
-            }
+        } else if (event.scancode == KEY_ENTER) {
             return selected;
         }
     }
@@ -186,13 +178,64 @@ static int do_login(void) {
     return do_login();
 }
 
-void kernel_main(void) {
+void kernel_main(boot_info_t* boot_info) {
+    boottime_init(boot_info);
+    screen_init_framebuffer(boot_info);
     screen_init();
+
+    // Copia de la consola por COM1 desde el primer mensaje
+    if (serial_init() == 0) {
+        screen_add_sink(serial_write);
+    }
     screen_clear();
 
     screen_print("EphemeralOS v1.0\n");
     screen_print("================\n\n");
 
+    // Detectar CPU y habilitar SSE si está disponible
+    cpu_init();
+    string_init();
+    if (cpu_sse_enabled()) {
+        screen_print("[CPU] SSE2 enabled\n");
+    }
+
+    // Mapa de memoria de la BIOS (E820) recogido por stage2
+    memmap_init(boot_info);
+    kprintf("[MEM] %u MB usable (%s)\n", memmap_total_usable() / (1024 * 1024),
+            memmap_from_bios() ? "E820" : "CMOS");
+
+    // Mapa 1:1 con páginas de 4 MB y tipos de caché por rango
+    paging_init();
+    if (paging_enabled()) {
+        screen_print("[MEM] Paging enabled with 4 MB pages");
+        screen_print(paging_pat_enabled() ? ", PAT write-combining available\n" : "\n");
+    }
+
+    // Consola gráfica: el framebuffer pasa a write-combining si hay PAT
+    uint32_t fb_base, fb_size;
+    if (screen_get_framebuffer(&fb_base, &fb_size)) {
+        int cols, rows;
+        screen_get_size(&cols, &rows);
+        kprintf("[VIDEO] Framebuffer console %dx%d%s\n", cols, rows,
+                paging_map_framebuffer(fb_base, fb_size) == 0 ? " (write-combining)" : "");
+    }
+
+    // Interrupciones, temporizador y planificador
+    kmem_init();
+    idt_init();
+    thread_init();
+    timer_init();
+    interrupts_enable();
+    boottime_sync_timer();
+    serial_enable_irq();
+    keyboard_init();
+    screen_print("[IRQ] IDT and PIC initialized\n");
+    screen_print("[SCHED] Preemptive scheduler running at 100 Hz\n");
+
+    // Tablas ACPI y arranque de los procesadores secundarios
+    acpi_init();
+    smp_init();
+
     // Inicializar RTC
     rtc_init();
     screen_print("[RTC] Real Time Clock initialized\n");
@@ -204,6 +247,7 @@ void kernel_main(void) {
     network_init();
     
     // Inicializar stack de red
+    csum_init();
     eth_init();
     arp_init();
     ip_init();
@@ -222,8 +266,13 @@ void kernel_main(void) {
         // Configurar DNS de QEMU (10.0.2.3)
         dns_set_server(0x0A000203); // 10.0.2.3
         screen_print("[NET] DNS server: 10.0.2.3\n");
+        
+        thread_create("netrx", net_rx_thread, 0);
     }
     
+    // Discos: virtio-blk si existe, si no el ATA del canal primario
+    blockdev_init();
+    
     screen_print("\n");
 
     if (!fs_check_installed()) {
@@ -245,10 +294,10 @@ void kernel_main(void) {
         screen_clear();
         screen_print("Rebooting...\n");
         for (volatile int i = 0; i < 30000000; i++);
-        asm volatile("int $0x19");
+        // Con la IDT del kernel cargada ya no se puede volver a la BIOS: reset por el 8042
+        asm volatile("outb %0, $0x64" : : "a"((uint8_t)0xFE));
     }
 
-    keyboard_init();
     fs_init();
 
     char hostname[64];
@@ -257,21 +306,14 @@ void kernel_main(void) {
     screen_clear();
     screen_init();
     
-    for (volatile int i = 0; i < 1000000; i++);
-    
-    for (int i = 0; i < 50; i++) {
-        uint8_t status;
-        asm volatile("inb $0x64, %0" : "=a"(status));
-        if (status & 0x01) {
-            uint8_t dummy;
-            asm volatile("inb $0x60, %0" : "=a"(dummy));
-        }
-    }
+    keyboard_flush();
     
     screen_set_color(0x0F, 0x00);
     screen_print(hostname);
     screen_print(" ");
     
+    // Fin del arranque: a partir de aquí el tiempo depende del usuario ('boottime')
+    boottime_mark(BOOT_STAGE_READY);
     do_login();
 
     screen_print("\n");
@@ -290,47 +332,10 @@ void kernel_main(void) {
     const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", 
                             "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
     
-    screen_print("Last login: ");
-    if (time.weekday >= 1 && time.weekday <= 7) {
-        screen_print(weekdays[time.weekday - 1]);
-    }
-    screen_print(" ");
-    if (time.month >= 1 && time.month <= 12) {
-        screen_print(months[time.month - 1]);
-    }
-    screen_print(" ");
-    
-    char num[3];
-    if (time.day < 10) screen_print(" ");
-    num[0] = '0' + (time.day / 10);
-    num[1] = '0' + (time.day % 10);
-    num[2] = '\0';
-    if (num[0] != '0') screen_print_char(num[0]);
-    screen_print_char(num[1]);
-    
-    screen_print(" ");
-    num[0] = '0' + (time.hour / 10);
-    num[1] = '0' + (time.hour % 10);
-    screen_print(num);
-    screen_print(":");
-    num[0] = '0' + (time.minute / 10);
-    num[1] = '0' + (time.minute % 10);
-    screen_print(num);
-    screen_print(":");
-    num[0] = '0' + (time.second / 10);
-    num[1] = '0' + (time.second % 10);
-    screen_print(num);
-    screen_print(" ");
-    
-    // Imprimir año
-    char year[5];
-    year[0] = '0' + (time.year / 1000);
-    year[1] = '0' + ((time.year / 100) % 10);
-    year[2] = '0' + ((time.year / 10) % 10);
-    year[3] = '0' + (time.year % 10);
-    year[4] = '\0';
-    screen_print(year);
-    screen_print("\n\n");
+    const char* weekday = time.weekday >= 1 && time.weekday <= 7 ? weekdays[time.weekday - 1] : "";
+    const char* month = time.month >= 1 && time.month <= 12 ? months[time.month - 1] : "";
+    kprintf("Last login: %s %s %2u %02u:%02u:%02u %04u\n\n", weekday, month,
+            time.day, time.hour, time.minute, time.second, time.year);
 
     shell_init();
     shell_run();
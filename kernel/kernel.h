@@ -4,7 +4,9 @@
 #include <stdint.h>
 #include <stddef.h>
 
-void kernel_main(void);
+struct boot_info;
+
+void kernel_main(struct boot_info* boot_info);
 
 void* memcpy(void* dest, const void* src, size_t n);
 void* memmove(void* dest, const void* src, size_t n);
@@ -18,4 +20,9 @@ char* strcat(char* dest, const char* src);
 size_t strlen(const char* s);
 int atoi(const char* str);
 
+// Elige las variantes SSE2 de memcpy/memset si la CPU las admite
+void string_init(void);
+int string_sse2_enabled(void);
+void string_set_sse2(int enable);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,222 @@
+// kernel/kprintf.c
+#include "kprintf.h"
+#include "../drivers/screen.h"
+
+// Destino con búfer: kprintf lo vuelca cuando se llena y al terminar,
+// ksnprintf trunca en silencio
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;
+    size_t total;
+    int console;
+} kbuf_t;
+
+static void kbuf_flush(kbuf_t* out) {
+    if (out->console && out->length > 0) {
+        out->buffer[out->length] = '\0';
+        screen_print(out->buffer);
+        out->length = 0;
+    }
+}
+
+static void kbuf_put(kbuf_t* out, char c) {
+    out->total++;
+    if (out->length + 1 >= out->size) {
+        if (!out->console) {
+            return;
+        }
+        kbuf_flush(out);
+    }
+    out->buffer[out->length++] = c;
+}
+
+static void kbuf_puts(kbuf_t* out, const char* s) {
+    while (*s) {
+        kbuf_put(out, *s++);
+    }
+}
+
+static void put_padded(kbuf_t* out, const char* s, int length, int width, int left, char pad) {
+    if (!left) {
+        // Con ceros el signo va delante del relleno
+        if (pad == '0' && *s == '-') {
+            kbuf_put(out, *s++);
+            length--;
+            width--;
+        }
+        while (width-- > length) {
+            kbuf_put(out, pad);
+        }
+    }
+    
+    for (int i = 0; i < length; i++) {
+        kbuf_put(out, s[i]);
+    }
+    
+    if (left) {
+        while (width-- > length) {
+            kbuf_put(out, ' ');
+        }
+    }
+}
+
+// Solo aritmética de 32 bits: el kernel no enlaza libgcc
+static int format_number(char* digits, uint32_t value, uint32_t base, int upper, int negative) {
+    const char* set = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char temp[11];
+    int length = 0;
+    
+    do {
+        temp[length++] = set[value % base];
+        value /= base;
+    } while (value > 0);
+    
+    int pos = 0;
+    if (negative) {
+        digits[pos++] = '-';
+    }
+    while (length > 0) {
+        digits[pos++] = temp[--length];
+    }
+    digits[pos] = '\0';
+    return pos;
+}
+
+static void format(kbuf_t* out, const char* fmt, va_list args) {
+    char digits[24];
+    
+    for (; *fmt; fmt++) {
+        if (*fmt != '%') {
+            kbuf_put(out, *fmt);
+            continue;
+        }
+        
+        fmt++;
+        int left = 0;
+        char pad = ' ';
+        int width = 0;
+        
+        for (;; fmt++) {
+            if (*fmt == '-') left = 1;
+            else if (*fmt == '0') pad = '0';
+            else break;
+        }
+        while (*fmt >= '0' && *fmt <= '9') {
+            width = width * 10 + (*fmt++ - '0');
+        }
+        // long e int miden lo mismo en i386
+        while (*fmt == 'l') {
+            fmt++;
+        }
+        if (left) {
+            pad = ' ';
+        }
+        
+        int length;
+        switch (*fmt) {
+            case 'd': {
+                int value = va_arg(args, int);
+                uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+                length = format_number(digits, magnitude, 10, 0, value < 0);
+                put_padded(out, digits, length, width, left, pad);
+                break;
+            }
+            case 'u':
+                length = format_number(digits, va_arg(args, uint32_t), 10, 0, 0);
+                put_padded(out, digits, length, width, left, pad);
+                break;
+            case 'x':
+            case 'X':
+                length = format_number(digits, va_arg(args, uint32_t), 16, *fmt == 'X', 0);
+                put_padded(out, digits, length, width, left, pad);
+                break;
+            case 'p': {
+                uint32_t value = (uint32_t)va_arg(args, void*);
+                kbuf_puts(out, "0x");
+                for (int shift = 28; shift >= 0; shift -= 4) {
+                    kbuf_put(out, "0123456789abcdef"[(value >> shift) & 0xF]);
+                }
+                break;
+            }
+            case 'c':
+                digits[0] = (char)va_arg(args, int);
+                put_padded(out, digits, 1, width, left, ' ');
+                break;
+            case 's': {
+                const char* s = va_arg(args, const char*);
+                if (!s) {
+                    s = "(null)";
+                }
+                put_padded(out, s, strlen(s), width, left, ' ');
+                break;
+            }
+            case 'I': {
+                uint32_t ip = va_arg(args, uint32_t);
+                length = 0;
+                for (int shift = 24; shift >= 0; shift -= 8) {
+                    length += format_number(digits + length, (ip >> shift) & 0xFF, 10, 0, 0);
+                    if (shift > 0) {
+                        digits[length++] = '.';
+                    }
+                }
+                put_padded(out, digits, length, width, left, ' ');
+                break;
+            }
+            case 'M': {
+                const uint8_t* mac = va_arg(args, const uint8_t*);
+                length = 0;
+                for (int i = 0; i < 6; i++) {
+                    digits[length++] = "0123456789ABCDEF"[mac[i] >> 4];
+                    digits[length++] = "0123456789ABCDEF"[mac[i] & 0xF];
+                    if (i < 5) {
+                        digits[length++] = ':';
+                    }
+                }
+                put_padded(out, digits, length, width, left, ' ');
+                break;
+            }
+            case '%':
+                kbuf_put(out, '%');
+                break;
+            case '\0':
+                return;
+            default:
+                kbuf_put(out, '%');
+                kbuf_put(out, *fmt);
+                break;
+        }
+    }
+}
+
+// Una sola llamada a screen_print por cada KPRINTF_BUFFER bytes en lugar de una por trozo
+int kprintf(const char* fmt, ...) {
+    char buffer[KPRINTF_BUFFER];
+    kbuf_t out = { buffer, sizeof(buffer), 0, 0, 1 };
+    
+    va_list args;
+    va_start(args, fmt);
+    format(&out, fmt, args);
+    va_end(args);
+    
+    kbuf_flush(&out);
+    return out.total;
+}
+
+int kvsnprintf(char* buffer, size_t size, const char* fmt, va_list args) {
+    kbuf_t out = { buffer, size, 0, 0, 0 };
+    
+    format(&out, fmt, args);
+    if (size > 0) {
+        buffer[out.length] = '\0';
+    }
+    return out.total;
+}
+
+int ksnprintf(char* buffer, size_t size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    int total = kvsnprintf(buffer, size, fmt, args);
+    va_end(args);
+    return total;
+}
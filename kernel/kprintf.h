@@ -0,0 +1,17 @@
+// kernel/kprintf.h
+#ifndef KPRINTF_H
+#define KPRINTF_H
+
+#include "kernel.h"
+#include <stdarg.h>
+
+// Trozo que kprintf acumula antes de volcar a la consola (y con ella al puerto serie)
+#define KPRINTF_BUFFER 256
+
+// %d %u %x %X %c %s %p %% con ancho, relleno con '0' y alineado a la izquierda con '-'.
+// Extensiones: %I dirección IPv4 (uint32_t en orden de host), %M MAC (const uint8_t*)
+int kprintf(const char* fmt, ...);
+int ksnprintf(char* buffer, size_t size, const char* fmt, ...);
+int kvsnprintf(char* buffer, size_t size, const char* fmt, va_list args);
+
+#endif
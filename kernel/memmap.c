@@ -0,0 +1,150 @@
+// kernel/memmap.c
+#include "memmap.h"
+
+static memmap_region_t regions[E820_MAX_ENTRIES];
+static int region_count = 0;
+static int from_bios = 0;
+static uint32_t ram_top = 0;
+static uint32_t total_usable = 0;
+
+static inline void outb(uint16_t port, uint8_t value) {
+    asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static inline uint8_t inb(uint16_t port) {
+    uint8_t ret;
+    asm volatile("inb %1, %0" : "=a"(ret) : "Nd"(port));
+    return ret;
+}
+
+static uint8_t cmos_read(uint8_t reg) {
+    outb(0x70, reg);
+    return inb(0x71);
+}
+
+// Tamaño de la RAM según la CMOS: memoria por encima de 16 MB en bloques de 64 KB,
+// o si no la hay, memoria extendida por encima de 1 MB en KB
+static uint32_t cmos_ram_top(void) {
+    uint32_t above_16m = cmos_read(0x34) | ((uint32_t)cmos_read(0x35) << 8);
+    if (above_16m) {
+        return 0x1000000 + above_16m * 0x10000;
+    }
+    
+    uint32_t extended_kb = cmos_read(0x30) | ((uint32_t)cmos_read(0x31) << 8);
+    return 0x100000 + extended_kb * 1024;
+}
+
+static void memmap_add(uint64_t base, uint64_t length, uint32_t type) {
+    if (region_count >= E820_MAX_ENTRIES || length == 0 || base >= 0x100000000ULL) {
+        return;
+    }
+    
+    // El kernel es de 32 bits: lo que pasa de 4 GB no es direccionable
+    uint64_t end = base + length;
+    if (end > 0x100000000ULL) {
+        end = 0x100000000ULL;
+    }
+    
+    memmap_region_t* r = &regions[region_count++];
+    r->base = (uint32_t)base;
+    r->length = (uint32_t)(end - base);
+    r->type = type;
+}
+
+static void memmap_sort(void) {
+    for (int i = 1; i < region_count; i++) {
+        memmap_region_t r = regions[i];
+        int j = i - 1;
+        while (j >= 0 && regions[j].base > r.base) {
+            regions[j + 1] = regions[j];
+            j--;
+        }
+        regions[j + 1] = r;
+    }
+}
+
+void memmap_init(const boot_info_t* info) {
+    region_count = 0;
+    from_bios = 0;
+    
+    if (info && info->magic == BOOT_INFO_MAGIC && info->e820_count > 0) {
+        uint32_t count = info->e820_count;
+        if (count > E820_MAX_ENTRIES) {
+            count = E820_MAX_ENTRIES;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            memmap_add(info->e820[i].base, info->e820[i].length, info->e820[i].type);
+        }
+        from_bios = region_count > 0;
+    }
+    
+    // Sin E820: memoria convencional y extendida según la CMOS
+    if (!from_bios) {
+        memmap_add(0, 0x9FC00, E820_USABLE);
+        memmap_add(0x100000, cmos_ram_top() - 0x100000, E820_USABLE);
+    }
+    
+    memmap_sort();
+    
+    ram_top = 0;
+    total_usable = 0;
+    for (int i = 0; i < region_count; i++) {
+        if (regions[i].type != E820_USABLE) {
+            continue;
+        }
+        total_usable += regions[i].length;
+        if (regions[i].base + regions[i].length > ram_top) {
+            ram_top = regions[i].base + regions[i].length;
+        }
+    }
+}
+
+int memmap_from_bios(void) {
+    return from_bios;
+}
+
+int memmap_count(void) {
+    return region_count;
+}
+
+const memmap_region_t* memmap_get(int index) {
+    if (index < 0 || index >= region_count) {
+        return 0;
+    }
+    return &regions[index];
+}
+
+uint32_t memmap_ram_top(void) {
+    return ram_top;
+}
+
+uint32_t memmap_total_usable(void) {
+    return total_usable;
+}
+
+int memmap_find_free(uint32_t min_base, uint32_t* base, uint32_t* length) {
+    uint32_t best_base = 0;
+    uint32_t best_length = 0;
+    
+    for (int i = 0; i < region_count; i++) {
+        const memmap_region_t* r = &regions[i];
+        if (r->type != E820_USABLE || r->base + r->length <= min_base) {
+            continue;
+        }
+        
+        uint32_t start = r->base < min_base ? min_base : r->base;
+        uint32_t size = r->base + r->length - start;
+        if (size > best_length) {
+            best_base = start;
+            best_length = size;
+        }
+    }
+    
+    if (best_length == 0) {
+        return 0;
+    }
+    
+    *base = best_base;
+    *length = best_length;
+    return 1;
+}
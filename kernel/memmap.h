@@ -0,0 +1,25 @@
+// kernel/memmap.h
+#ifndef MEMMAP_H
+#define MEMMAP_H
+
+#include "kernel.h"
+#include "bootinfo.h"
+
+// Regiones del mapa E820 recortadas a los primeros 4 GB y ordenadas por dirección
+typedef struct {
+    uint32_t base;
+    uint32_t length;
+    uint32_t type;
+} memmap_region_t;
+
+void memmap_init(const boot_info_t* info);
+int memmap_from_bios(void);
+int memmap_count(void);
+const memmap_region_t* memmap_get(int index);
+uint32_t memmap_ram_top(void);
+uint32_t memmap_total_usable(void);
+
+// Mayor región utilizable que empieza en min_base o por encima; 0 si no hay ninguna
+int memmap_find_free(uint32_t min_base, uint32_t* base, uint32_t* length);
+
+#endif
@@ -0,0 +1,58 @@
+// kernel/memory.c
+#include "memory.h"
+#include "spinlock.h"
+#include "memmap.h"
+
+static uint32_t kmem_next = KMEM_BASE;
+static uint32_t kmem_end = KMEM_DEFAULT_LIMIT;
+static uint32_t kmem_start = KMEM_BASE;
+static spinlock_t kmem_lock;
+
+void kmem_init(void) {
+    spin_lock_init(&kmem_lock, "kmem");
+    kmem_next = KMEM_BASE;
+    kmem_end = KMEM_DEFAULT_LIMIT;
+    kmem_start = KMEM_BASE;
+    
+    // Mayor región libre por encima del primer mega según el mapa de memoria
+    uint32_t base, length;
+    if (memmap_find_free(KMEM_BASE, &base, &length)) {
+        kmem_next = (base + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+        kmem_end = (base + length) & ~(PAGE_SIZE - 1);
+        kmem_start = kmem_next;
+    }
+}
+
+// Asignador lineal de páginas: lo reservado no se libera nunca
+void* kmem_alloc_pages(uint32_t count) {
+    uint32_t size = count * PAGE_SIZE;
+    uint32_t flags = spin_lock_irqsave(&kmem_lock);
+    
+    if (count == 0 || size > kmem_end - kmem_next) {
+        spin_unlock_irqrestore(&kmem_lock, flags);
+        return 0;
+    }
+    
+    void* pages = (void*)kmem_next;
+    kmem_next += size;
+    spin_unlock_irqrestore(&kmem_lock, flags);
+    
+    memset(pages, 0, size);
+    return pages;
+}
+
+uint32_t kmem_used(void) {
+    return kmem_next - kmem_start;
+}
+
+uint32_t kmem_limit(void) {
+    return kmem_end;
+}
+
+uint32_t kmem_base(void) {
+    return kmem_start;
+}
+
+void* kmem_alloc(uint32_t bytes) {
+    return kmem_alloc_pages((bytes + PAGE_SIZE - 1) / PAGE_SIZE);
+}
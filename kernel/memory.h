@@ -0,0 +1,20 @@
+// kernel/memory.h
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include "kernel.h"
+
+#define PAGE_SIZE 4096
+
+// Memoria libre por encima del primer mega (la imagen del kernel vive por debajo)
+#define KMEM_BASE 0x100000
+#define KMEM_DEFAULT_LIMIT 0x1000000
+
+void kmem_init(void);
+void* kmem_alloc_pages(uint32_t count);
+void* kmem_alloc(uint32_t bytes);
+uint32_t kmem_used(void);
+uint32_t kmem_limit(void);
+uint32_t kmem_base(void);
+
+#endif
@@ -0,0 +1,107 @@
+// kernel/paging.c
+#include "paging.h"
+#include "cpu.h"
+#include "memmap.h"
+
+static uint32_t page_directory[PAGE_DIRECTORY_ENTRIES] __attribute__((aligned(4096)));
+static uint32_t ram_top = 0;
+static int pat_enabled = 0;
+static int pge_enabled = 0;
+static int enabled = 0;
+
+static void pat_init(void) {
+    // Por defecto: WB, WT, UC-, UC repetido. La entrada 1 (PWT) pasa de WT a WC
+    uint64_t pat = (uint64_t)PAT_TYPE_WB |
+                   ((uint64_t)PAT_TYPE_WC << 8) |
+                   ((uint64_t)PAT_TYPE_UC_MINUS << 16) |
+                   ((uint64_t)PAT_TYPE_UC << 24);
+    pat |= pat << 32;
+    cpu_write_msr(MSR_PAT, pat);
+}
+
+static void paging_load(void) {
+    uint32_t cr0, cr4;
+    
+    if (pat_enabled) {
+        pat_init();
+    }
+    
+    asm volatile("mov %%cr4, %0" : "=r"(cr4));
+    cr4 |= (1 << 4);    // PSE
+    if (pge_enabled) {
+        cr4 |= (1 << 7);    // PGE
+    }
+    asm volatile("mov %0, %%cr4" : : "r"(cr4));
+    
+    asm volatile("mov %0, %%cr3" : : "r"(page_directory) : "memory");
+    
+    asm volatile("mov %%cr0, %0" : "=r"(cr0));
+    cr0 |= (1u << 31);  // PG
+    asm volatile("mov %0, %%cr0" : : "r"(cr0) : "memory");
+}
+
+void paging_init(void) {
+    if (!cpu_has_feature(CPUID_EDX_PSE)) {
+        return;
+    }
+    
+    pat_enabled = cpu_has_feature(CPUID_EDX_PAT);
+    pge_enabled = cpu_has_feature(CPUID_EDX_PGE);
+    ram_top = memmap_ram_top();
+    
+    // RAM con caché normal; por encima (PCI, APIC, BIOS) sin caché
+    uint32_t global = pge_enabled ? PDE_GLOBAL : 0;
+    for (uint32_t i = 0; i < PAGE_DIRECTORY_ENTRIES; i++) {
+        uint32_t base = i * PAGE_LARGE_SIZE;
+        uint32_t cache = base < ram_top ? PAGE_CACHE_WB : PAGE_CACHE_UC;
+        page_directory[i] = base | PDE_PRESENT | PDE_WRITE | PDE_LARGE | global | cache;
+    }
+    
+    paging_load();
+    enabled = 1;
+}
+
+// Los AP comparten el directorio; solo tienen que cargar sus propios registros
+void paging_init_ap(void) {
+    if (enabled) {
+        paging_load();
+    }
+}
+
+int paging_enabled(void) {
+    return enabled;
+}
+
+int paging_pat_enabled(void) {
+    return pat_enabled;
+}
+
+uint32_t paging_ram_top(void) {
+    return ram_top;
+}
+
+int paging_set_cache(uint32_t phys, uint32_t size, uint32_t cache) {
+    if (!enabled || size == 0) {
+        return -1;
+    }
+    // Sin PAT la entrada PWT sería write-through, no write-combining
+    if (cache == PAGE_CACHE_WC && !pat_enabled) {
+        return -1;
+    }
+    
+    uint32_t first = phys / PAGE_LARGE_SIZE;
+    uint32_t last = (phys + size - 1) / PAGE_LARGE_SIZE;
+    
+    for (uint32_t i = first; i <= last && i < PAGE_DIRECTORY_ENTRIES; i++) {
+        page_directory[i] = (page_directory[i] & ~(PDE_PCD | PDE_PWT | PDE_PAT_LARGE)) | cache;
+        asm volatile("invlpg (%0)" : : "r"(i * PAGE_LARGE_SIZE) : "memory");
+    }
+    
+    // Cambiar el tipo de memoria exige vaciar las cachés de las líneas ya cargadas
+    asm volatile("wbinvd" : : : "memory");
+    return 0;
+}
+
+int paging_map_framebuffer(uint32_t phys, uint32_t size) {
+    return paging_set_cache(phys, size, PAGE_CACHE_WC);
+}
@@ -0,0 +1,43 @@
+// kernel/paging.h
+#ifndef PAGING_H
+#define PAGING_H
+
+#include "kernel.h"
+
+// Todo el espacio de 4 GB se mapea 1:1 con páginas de 4 MB (PSE)
+#define PAGE_LARGE_SIZE 0x400000
+#define PAGE_DIRECTORY_ENTRIES 1024
+
+#define PDE_PRESENT   0x001
+#define PDE_WRITE     0x002
+#define PDE_USER      0x004
+#define PDE_PWT       0x008
+#define PDE_PCD       0x010
+#define PDE_LARGE     0x080
+#define PDE_GLOBAL    0x100
+#define PDE_PAT_LARGE 0x1000
+
+// Tipos de caché expresados como bits PAT/PCD/PWT; la entrada 1 del PAT se reprograma a WC
+#define PAGE_CACHE_WB 0
+#define PAGE_CACHE_WC PDE_PWT
+#define PAGE_CACHE_UC (PDE_PCD | PDE_PWT)
+
+#define MSR_PAT 0x277
+#define PAT_TYPE_UC 0x00
+#define PAT_TYPE_WC 0x01
+#define PAT_TYPE_WT 0x04
+#define PAT_TYPE_WB 0x06
+#define PAT_TYPE_UC_MINUS 0x07
+
+void paging_init(void);
+void paging_init_ap(void);
+int paging_enabled(void);
+int paging_pat_enabled(void);
+uint32_t paging_ram_top(void);
+
+// Cambia el tipo de caché de un rango redondeado a páginas de 4 MB.
+// Solo se usa durante el arranque, antes de despertar a los demás procesadores
+int paging_set_cache(uint32_t phys, uint32_t size, uint32_t cache);
+int paging_map_framebuffer(uint32_t phys, uint32_t size);
+
+#endif
@@ -0,0 +1,124 @@
+// kernel/ring.c
+#include "ring.h"
+#include "atomic.h"
+
+static int is_power_of_two(uint32_t n) {
+    return n && (n & (n - 1)) == 0;
+}
+
+int spsc_ring_init(spsc_ring_t* ring, void** slots, uint32_t size) {
+    if (!slots || !is_power_of_two(size)) {
+        return -1;
+    }
+    
+    ring->slots = slots;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    return 0;
+}
+
+int spsc_ring_push(spsc_ring_t* ring, void* item) {
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    
+    if (head - tail > ring->mask) {
+        return -1;
+    }
+    
+    // El dato debe ser visible antes que el nuevo head
+    ring->slots[head & ring->mask] = item;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+int spsc_ring_pop(spsc_ring_t* ring, void** item) {
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    
+    if (head == tail) {
+        return -1;
+    }
+    
+    *item = ring->slots[tail & ring->mask];
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t* ring) {
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) -
+           __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+int mpmc_ring_init(mpmc_ring_t* ring, mpmc_cell_t* cells, uint32_t size) {
+    if (!cells || !is_power_of_two(size)) {
+        return -1;
+    }
+    
+    ring->cells = cells;
+    ring->mask = size - 1;
+    for (uint32_t i = 0; i < size; i++) {
+        cells[i].sequence = i;
+        cells[i].data = 0;
+    }
+    ring->enqueue_pos = 0;
+    ring->dequeue_pos = 0;
+    return 0;
+}
+
+// Una celda está libre para la posición pos cuando su secuencia vale pos
+int mpmc_ring_push(mpmc_ring_t* ring, void* item) {
+    uint32_t pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+    mpmc_cell_t* cell;
+    
+    for (;;) {
+        cell = &ring->cells[pos & ring->mask];
+        uint32_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - pos);
+        
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->enqueue_pos, &pos, pos + 1, 0,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1;
+        } else {
+            pos = __atomic_load_n(&ring->enqueue_pos, __ATOMIC_RELAXED);
+        }
+        cpu_relax();
+    }
+    
+    cell->data = item;
+    __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+// Una celda tiene dato para la posición pos cuando su secuencia vale pos + 1
+int mpmc_ring_pop(mpmc_ring_t* ring, void** item) {
+    uint32_t pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+    mpmc_cell_t* cell;
+    
+    for (;;) {
+        cell = &ring->cells[pos & ring->mask];
+        uint32_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int32_t diff = (int32_t)(seq - (pos + 1));
+        
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->dequeue_pos, &pos, pos + 1, 0,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return -1;
+        } else {
+            pos = __atomic_load_n(&ring->dequeue_pos, __ATOMIC_RELAXED);
+        }
+        cpu_relax();
+    }
+    
+    *item = cell->data;
+    // La celda vuelve a estar libre una vuelta completa más tarde
+    __atomic_store_n(&cell->sequence, pos + ring->mask + 1, __ATOMIC_RELEASE);
+    return 0;
+}
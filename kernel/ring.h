@@ -0,0 +1,41 @@
+// kernel/ring.h
+#ifndef RING_H
+#define RING_H
+
+#include "kernel.h"
+
+// Anillos sin cerrojos de punteros. El almacenamiento lo aporta el llamador
+// y el tamaño debe ser potencia de dos
+
+// Un productor y un consumidor: cada índice lo escribe un solo lado
+typedef struct {
+    void** slots;
+    uint32_t mask;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+} spsc_ring_t;
+
+// Varios productores y consumidores: cada celda lleva un número de secuencia
+typedef struct {
+    volatile uint32_t sequence;
+    void* data;
+} mpmc_cell_t;
+
+typedef struct {
+    mpmc_cell_t* cells;
+    uint32_t mask;
+    // Índices en líneas de caché distintas para que productores y consumidores no compitan
+    volatile uint32_t enqueue_pos __attribute__((aligned(64)));
+    volatile uint32_t dequeue_pos __attribute__((aligned(64)));
+} mpmc_ring_t;
+
+int spsc_ring_init(spsc_ring_t* ring, void** slots, uint32_t size);
+int spsc_ring_push(spsc_ring_t* ring, void* item);
+int spsc_ring_pop(spsc_ring_t* ring, void** item);
+uint32_t spsc_ring_count(const spsc_ring_t* ring);
+
+int mpmc_ring_init(mpmc_ring_t* ring, mpmc_cell_t* cells, uint32_t size);
+int mpmc_ring_push(mpmc_ring_t* ring, void* item);
+int mpmc_ring_pop(mpmc_ring_t* ring, void** item);
+
+#endif
@@ -0,0 +1,194 @@
+// kernel/smp.c
+#include "smp.h"
+#include "acpi.h"
+#include "apic.h"
+#include "cpu.h"
+#include "idt.h"
+#include "memory.h"
+#include "paging.h"
+#include "thread.h"
+#include "timer.h"
+#include "kprintf.h"
+#include "../drivers/screen.h"
+
+static cpu_local_t cpus[SMP_MAX_CPUS];
+static int cpu_count = 0;
+static int smp_ready = 0;
+static uint8_t apic_to_cpu[256];
+
+// Símbolos de trampoline.asm
+extern uint8_t ap_trampoline_start[];
+extern uint8_t ap_trampoline_end[];
+extern uint8_t ap_trampoline_stack[];
+extern uint8_t ap_trampoline_entry[];
+
+static void ap_main(void);
+
+static void apic_timer_handler(interrupt_frame_t* frame) {
+    (void)frame;
+    lapic_eoi();
+    thread_tick();
+}
+
+static void smp_parse_madt(const acpi_madt_t* madt) {
+    const uint8_t* p = (const uint8_t*)madt + sizeof(acpi_madt_t);
+    const uint8_t* end = (const uint8_t*)madt + madt->header.length;
+    
+    while (p + sizeof(madt_entry_t) <= end) {
+        const madt_entry_t* entry = (const madt_entry_t*)p;
+        if (entry->length < sizeof(madt_entry_t)) {
+            break;
+        }
+        
+        if (entry->type == MADT_TYPE_LAPIC) {
+            const madt_lapic_t* l = (const madt_lapic_t*)entry;
+            // Bit 0: procesador habilitado
+            if ((l->flags & 1) && cpu_count < SMP_MAX_CPUS) {
+                cpus[cpu_count].id = cpu_count;
+                cpus[cpu_count].apic_id = l->apic_id;
+                apic_to_cpu[l->apic_id] = cpu_count;
+                cpu_count++;
+            }
+        } else if (entry->type == MADT_TYPE_IOAPIC) {
+            const madt_ioapic_t* io = (const madt_ioapic_t*)entry;
+            ioapic_init(io->address, io->gsi_base);
+        } else if (entry->type == MADT_TYPE_IRQ_OVERRIDE) {
+            const madt_irq_override_t* o = (const madt_irq_override_t*)entry;
+            ioapic_set_override(o->source, o->gsi, o->flags);
+        }
+        
+        p += entry->length;
+    }
+}
+
+static int smp_start_ap(cpu_local_t* cpu) {
+    uint8_t* stack = kmem_alloc_pages(SMP_AP_STACK_PAGES);
+    if (!stack) {
+        return -1;
+    }
+    
+    // Cada AP recibe su pila y el punto de entrada en la copia del trampolín
+    uint8_t* tramp = (uint8_t*)SMP_TRAMPOLINE_ADDR;
+    uint32_t stack_top = (uint32_t)stack + SMP_AP_STACK_PAGES * PAGE_SIZE;
+    uint32_t entry = (uint32_t)ap_main;
+    memcpy(tramp + (ap_trampoline_stack - ap_trampoline_start), &stack_top, 4);
+    memcpy(tramp + (ap_trampoline_entry - ap_trampoline_start), &entry, 4);
+    
+    lapic_send_init(cpu->apic_id);
+    
+    for (int attempt = 0; attempt < 2 && !cpu->online; attempt++) {
+        lapic_send_startup(cpu->apic_id, SMP_TRAMPOLINE_ADDR >> 12);
+    }
+    
+    uint32_t deadline = timer_get_ms() + 200;
+    while (!cpu->online && (int32_t)(deadline - timer_get_ms()) > 0) {
+        asm volatile("pause");
+    }
+    
+    return cpu->online ? 0 : -1;
+}
+
+void smp_init(void) {
+    memset(cpus, 0, sizeof(cpus));
+    memset(apic_to_cpu, 0, sizeof(apic_to_cpu));
+    cpu_count = 0;
+    
+    const acpi_madt_t* madt = (const acpi_madt_t*)acpi_find_table("APIC");
+    if (!madt || !cpu_has_feature(CPUID_EDX_APIC)) {
+        cpu_count = 1;
+        cpus[0].online = 1;
+        cpus[0].bsp = 1;
+        screen_print("[SMP] No MADT found, running on the boot processor only\n");
+        return;
+    }
+    
+    lapic_init(madt->lapic_address);
+    smp_parse_madt(madt);
+    lapic_enable();
+    
+    if (cpu_count == 0) {
+        cpu_count = 1;
+        cpus[0].apic_id = lapic_id();
+    }
+    
+    // El BSP puede no ser la primera entrada de la MADT; el planificador lo espera en la 0
+    int bsp = apic_to_cpu[lapic_id()];
+    if (bsp != 0) {
+        uint8_t apic_id = cpus[bsp].apic_id;
+        cpus[bsp].apic_id = cpus[0].apic_id;
+        cpus[0].apic_id = apic_id;
+        apic_to_cpu[cpus[bsp].apic_id] = bsp;
+        apic_to_cpu[apic_id] = 0;
+        bsp = 0;
+    }
+    cpus[0].online = 1;
+    cpus[0].bsp = 1;
+    
+    irq_register_vector(APIC_TIMER_VECTOR, apic_timer_handler);
+    smp_ready = 1;
+    
+    lapic_timer_calibrate();
+    
+    uint32_t size = ap_trampoline_end - ap_trampoline_start;
+    memcpy((void*)SMP_TRAMPOLINE_ADDR, ap_trampoline_start, size);
+    
+    for (int i = 0; i < cpu_count; i++) {
+        if (i == bsp) {
+            continue;
+        }
+        if (smp_start_ap(&cpus[i]) != 0) {
+            kprintf("[SMP] CPU %d did not respond\n", i);
+        }
+    }
+    
+    kprintf("[SMP] %d of %d CPUs online\n", smp_online_count(), cpu_count);
+}
+
+// Entrada en C de los procesadores secundarios desde el trampolín
+static void ap_main(void) {
+    cpu_init_ap();
+    paging_init_ap();
+    idt_install();
+    lapic_enable();
+    
+    int id = smp_cpu_id();
+    
+    // El contexto de arranque pasa a ser el hilo ocioso de este procesador
+    thread_init_ap(id);
+    cpus[id].online = 1;
+    
+    lapic_timer_start();
+    interrupts_enable();
+    
+    for (;;) {
+        asm volatile("hlt");
+    }
+}
+
+int smp_cpu_id(void) {
+    if (!smp_ready) {
+        return 0;
+    }
+    return apic_to_cpu[lapic_id()];
+}
+
+int smp_cpu_count(void) {
+    return cpu_count ? cpu_count : 1;
+}
+
+int smp_online_count(void) {
+    int count = 0;
+    for (int i = 0; i < cpu_count; i++) {
+        if (cpus[i].online) {
+            count++;
+        }
+    }
+    return count ? count : 1;
+}
+
+const cpu_local_t* smp_get_cpu(int id) {
+    if (id < 0 || id >= cpu_count) {
+        return 0;
+    }
+    return &cpus[id];
+}
@@ -0,0 +1,25 @@
+// kernel/smp.h
+#ifndef SMP_H
+#define SMP_H
+
+#include "kernel.h"
+
+#define SMP_MAX_CPUS 8
+// Página física donde se copia el trampolín; el vector SIPI es la página
+#define SMP_TRAMPOLINE_ADDR 0x8000
+#define SMP_AP_STACK_PAGES 4
+
+typedef struct {
+    int id;
+    uint8_t apic_id;
+    volatile int online;
+    int bsp;
+} cpu_local_t;
+
+void smp_init(void);
+int smp_cpu_id(void);
+int smp_cpu_count(void);
+int smp_online_count(void);
+const cpu_local_t* smp_get_cpu(int id);
+
+#endif
@@ -0,0 +1,189 @@
+// kernel/spinlock.c
+#include "spinlock.h"
+#include "atomic.h"
+#include "idt.h"
+
+#ifdef LOCK_STATS
+static spinlock_t* stats_head = 0;
+static spinlock_t registry_lock;
+
+static int stats_registered(spinlock_t* lock) {
+    for (spinlock_t* it = stats_head; it; it = it->stats_next) {
+        if (it == lock) {
+            return 1;
+        }
+    }
+    return 0;
+}
+#endif
+
+void spin_lock_init(spinlock_t* lock, const char* name) {
+    lock->owner = 0;
+    lock->next = 0;
+    lock->name = name;
+    
+#ifdef LOCK_STATS
+    memset(&lock->stats, 0, sizeof(lock_stats_t));
+    
+    // El registro usa un cerrojo que no se registra a sí mismo
+    uint32_t flags = irq_save();
+    spin_lock(&registry_lock);
+    if (!stats_registered(lock)) {
+        lock->stats_next = stats_head;
+        stats_head = lock;
+    }
+    spin_unlock(&registry_lock);
+    irq_restore(flags);
+#endif
+}
+
+void spin_lock(spinlock_t* lock) {
+    uint16_t ticket = __atomic_fetch_add(&lock->next, 1, __ATOMIC_ACQUIRE);
+    
+#ifdef LOCK_STATS
+    uint32_t spins = 0;
+    while (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket) {
+        cpu_relax();
+        spins++;
+    }
+    
+    // Los contadores se actualizan ya con el cerrojo tomado
+    lock->stats.acquisitions++;
+    if (spins) {
+        lock->stats.contended++;
+        lock->stats.spins += spins;
+        if (spins > lock->stats.max_spins) {
+            lock->stats.max_spins = spins;
+        }
+    }
+#else
+    while (__atomic_load_n(&lock->owner, __ATOMIC_ACQUIRE) != ticket) {
+        cpu_relax();
+    }
+#endif
+}
+
+void spin_unlock(spinlock_t* lock) {
+    // Solo el dueño escribe owner, así que no hace falta una operación atómica
+    __atomic_store_n(&lock->owner, (uint16_t)(lock->owner + 1), __ATOMIC_RELEASE);
+}
+
+int spin_trylock(spinlock_t* lock) {
+    // owner y next forman una palabra: libre cuando ambos coinciden
+    volatile uint32_t* word = (volatile uint32_t*)&lock->owner;
+    uint32_t old = *word;
+    
+    if ((old & 0xFFFF) != (old >> 16)) {
+        return 0;
+    }
+    if (!__sync_bool_compare_and_swap(word, old, old + 0x10000)) {
+        return 0;
+    }
+    
+#ifdef LOCK_STATS
+    lock->stats.acquisitions++;
+#endif
+    return 1;
+}
+
+int spin_is_locked(spinlock_t* lock) {
+    return lock->owner != lock->next;
+}
+
+uint32_t spin_lock_irqsave(spinlock_t* lock) {
+    uint32_t flags = irq_save();
+    spin_lock(lock);
+    return flags;
+}
+
+void spin_unlock_irqrestore(spinlock_t* lock, uint32_t flags) {
+    spin_unlock(lock);
+    irq_restore(flags);
+}
+
+void rwlock_init(rwlock_t* lock, const char* name) {
+    spin_lock_init(&lock->gate, name);
+    lock->readers = 0;
+}
+
+void read_lock(rwlock_t* lock) {
+    // La puerta solo se toma un instante: un escritor en espera la mantiene cerrada
+    spin_lock(&lock->gate);
+    __atomic_add_fetch(&lock->readers, 1, __ATOMIC_ACQUIRE);
+    spin_unlock(&lock->gate);
+}
+
+void read_unlock(rwlock_t* lock) {
+    __atomic_sub_fetch(&lock->readers, 1, __ATOMIC_RELEASE);
+}
+
+void write_lock(rwlock_t* lock) {
+    spin_lock(&lock->gate);
+    while (__atomic_load_n(&lock->readers, __ATOMIC_ACQUIRE) != 0) {
+        cpu_relax();
+    }
+}
+
+void write_unlock(rwlock_t* lock) {
+    spin_unlock(&lock->gate);
+}
+
+uint32_t read_lock_irqsave(rwlock_t* lock) {
+    uint32_t flags = irq_save();
+    read_lock(lock);
+    return flags;
+}
+
+void read_unlock_irqrestore(rwlock_t* lock, uint32_t flags) {
+    read_unlock(lock);
+    irq_restore(flags);
+}
+
+uint32_t write_lock_irqsave(rwlock_t* lock) {
+    uint32_t flags = irq_save();
+    write_lock(lock);
+    return flags;
+}
+
+void write_unlock_irqrestore(rwlock_t* lock, uint32_t flags) {
+    write_unlock(lock);
+    irq_restore(flags);
+}
+
+int spinlock_stats_enabled(void) {
+#ifdef LOCK_STATS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+const spinlock_t* spinlock_stats_next(const spinlock_t* prev) {
+#ifdef LOCK_STATS
+    return prev ? prev->stats_next : stats_head;
+#else
+    (void)prev;
+    return 0;
+#endif
+}
+
+void spinlock_get_stats(const spinlock_t* lock, lock_stats_t* stats) {
+#ifdef LOCK_STATS
+    memcpy(stats, &lock->stats, sizeof(lock_stats_t));
+#else
+    (void)lock;
+    memset(stats, 0, sizeof(lock_stats_t));
+#endif
+}
+
+void spinlock_stats_reset(void) {
+#ifdef LOCK_STATS
+    uint32_t flags = irq_save();
+    spin_lock(&registry_lock);
+    for (spinlock_t* it = stats_head; it; it = it->stats_next) {
+        memset(&it->stats, 0, sizeof(lock_stats_t));
+    }
+    spin_unlock(&registry_lock);
+    irq_restore(flags);
+#endif
+}
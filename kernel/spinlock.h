@@ -0,0 +1,58 @@
+// kernel/spinlock.h
+#ifndef SPINLOCK_H
+#define SPINLOCK_H
+
+#include "kernel.h"
+
+// Con -DLOCK_STATS (make LOCK_STATS=1) cada cerrojo cuenta adquisiciones y esperas
+typedef struct {
+    uint32_t acquisitions;
+    uint32_t contended;
+    uint32_t spins;
+    uint32_t max_spins;
+} lock_stats_t;
+
+// Cerrojo de tickets: se atiende en orden de llegada. Todo a cero es un cerrojo libre
+typedef struct spinlock {
+    volatile uint16_t owner;
+    volatile uint16_t next;
+    const char* name;
+#ifdef LOCK_STATS
+    lock_stats_t stats;
+    struct spinlock* stats_next;
+#endif
+} spinlock_t;
+
+// Lectores/escritor: el escritor cierra la puerta a lectores nuevos y espera a que salgan
+typedef struct {
+    spinlock_t gate;
+    volatile int32_t readers;
+} rwlock_t;
+
+void spin_lock_init(spinlock_t* lock, const char* name);
+void spin_lock(spinlock_t* lock);
+void spin_unlock(spinlock_t* lock);
+int spin_trylock(spinlock_t* lock);
+int spin_is_locked(spinlock_t* lock);
+
+// Variantes que además desactivan interrupciones (y con ello la expulsión)
+uint32_t spin_lock_irqsave(spinlock_t* lock);
+void spin_unlock_irqrestore(spinlock_t* lock, uint32_t flags);
+
+void rwlock_init(rwlock_t* lock, const char* name);
+void read_lock(rwlock_t* lock);
+void read_unlock(rwlock_t* lock);
+void write_lock(rwlock_t* lock);
+void write_unlock(rwlock_t* lock);
+uint32_t read_lock_irqsave(rwlock_t* lock);
+void read_unlock_irqrestore(rwlock_t* lock, uint32_t flags);
+uint32_t write_lock_irqsave(rwlock_t* lock);
+void write_unlock_irqrestore(rwlock_t* lock, uint32_t flags);
+
+// Recorrido de las estadísticas; sin LOCK_STATS no hay cerrojos registrados
+int spinlock_stats_enabled(void);
+const spinlock_t* spinlock_stats_next(const spinlock_t* prev);
+void spinlock_get_stats(const spinlock_t* lock, lock_stats_t* stats);
+void spinlock_stats_reset(void);
+
+#endif
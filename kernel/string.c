@@ -1,11 +1,138 @@
 #include "kernel.h"
+#include "cpu.h"
+
+// Copias y rellenos con rep movsd/stosd; por encima de STRING_SSE2_MIN bytes y con
+// SSE2 disponible se usan bloques de 64 bytes en registros XMM
+#define STRING_SSE2_MIN 512
+
+#define ONES  0x01010101u
+#define HIGHS 0x80808080u
+
+// Distinto de cero si alguno de los cuatro bytes de la palabra es cero
+#define HAS_ZERO(w) (((w) - ONES) & ~(w) & HIGHS)
+
+static int use_sse2 = 0;
+
+void string_init(void) {
+    use_sse2 = cpu_sse_enabled();
+}
+
+int string_sse2_enabled(void) {
+    return use_sse2;
+}
+
+// Para medir: permite comparar con y sin SSE2 en la misma máquina
+void string_set_sse2(int enable) {
+    use_sse2 = enable && cpu_sse_enabled();
+}
+
+static inline void copy_forward(void* dest, const void* src, size_t n) {
+    uint32_t d0, d1, d2;
+    asm volatile("rep movsl\n\t"
+                 "movl %4, %%ecx\n\t"
+                 "rep movsb"
+                 : "=&c"(d0), "=&D"(d1), "=&S"(d2)
+                 : "0"(n >> 2), "g"(n & 3), "1"(dest), "2"(src)
+                 : "memory");
+}
+
+static inline void fill(void* dest, uint32_t pattern, size_t n) {
+    uint32_t d0, d1;
+    asm volatile("rep stosl\n\t"
+                 "movl %3, %%ecx\n\t"
+                 "rep stosb"
+                 : "=&c"(d0), "=&D"(d1)
+                 : "a"(pattern), "g"(n & 3), "0"(n >> 2), "1"(dest)
+                 : "memory");
+}
+
+// Los XMM que se tocan se guardan y restauran: una IRQ puede copiar en mitad
+// de la copia de un hilo y el kernel no marca el estado SSE como usado
+static void copy_sse2(uint8_t* d, const uint8_t* s, size_t n) {
+    uint8_t saved[64];
+    
+    // Destino alineado a 16 para los movntdq
+    size_t head = (16 - ((uint32_t)d & 15)) & 15;
+    copy_forward(d, s, head);
+    d += head;
+    s += head;
+    n -= head;
+    
+    asm volatile("movdqu %%xmm0, 0(%0)\n\t"
+                 "movdqu %%xmm1, 16(%0)\n\t"
+                 "movdqu %%xmm2, 32(%0)\n\t"
+                 "movdqu %%xmm3, 48(%0)"
+                 : : "r"(saved) : "memory");
+    
+    size_t blocks = n >> 6;
+    while (blocks--) {
+        asm volatile("movdqu 0(%1), %%xmm0\n\t"
+                     "movdqu 16(%1), %%xmm1\n\t"
+                     "movdqu 32(%1), %%xmm2\n\t"
+                     "movdqu 48(%1), %%xmm3\n\t"
+                     "movntdq %%xmm0, 0(%0)\n\t"
+                     "movntdq %%xmm1, 16(%0)\n\t"
+                     "movntdq %%xmm2, 32(%0)\n\t"
+                     "movntdq %%xmm3, 48(%0)"
+                     : : "r"(d), "r"(s) : "memory");
+        d += 64;
+        s += 64;
+    }
+    
+    // Los almacenamientos no temporales deben ser visibles antes de volver
+    asm volatile("sfence\n\t"
+                 "movdqu 0(%0), %%xmm0\n\t"
+                 "movdqu 16(%0), %%xmm1\n\t"
+                 "movdqu 32(%0), %%xmm2\n\t"
+                 "movdqu 48(%0), %%xmm3"
+                 : : "r"(saved) : "memory");
+    
+    copy_forward(d, s, n & 63);
+}
+
+static void fill_sse2(uint8_t* d, uint32_t pattern, size_t n) {
+    uint8_t saved[16];
+    uint32_t block[4] = { pattern, pattern, pattern, pattern };
+    
+    size_t head = (16 - ((uint32_t)d & 15)) & 15;
+    fill(d, pattern, head);
+    d += head;
+    n -= head;
+    
+    asm volatile("movdqu %%xmm0, (%0)\n\t"
+                 "movdqu (%1), %%xmm0"
+                 : : "r"(saved), "r"(block) : "memory");
+    
+    size_t blocks = n >> 6;
+    while (blocks--) {
+        asm volatile("movntdq %%xmm0, 0(%0)\n\t"
+                     "movntdq %%xmm0, 16(%0)\n\t"
+                     "movntdq %%xmm0, 32(%0)\n\t"
+                     "movntdq %%xmm0, 48(%0)"
+                     : : "r"(d) : "memory");
+        d += 64;
+    }
+    
+    asm volatile("sfence\n\t"
+                 "movdqu (%0), %%xmm0"
+                 : : "r"(saved) : "memory");
+    
+    fill(d, pattern, n & 63);
+}
 
 void* memcpy(void* dest, const void* src, size_t n) {
-    uint8_t* d = (uint8_t*)dest;
-    const uint8_t* s = (const uint8_t*)src;
-    while (n--) {
-        *d++ = *s++;
+    if (use_sse2 && n >= STRING_SSE2_MIN) {
+        copy_sse2((uint8_t*)dest, (const uint8_t*)src, n);
+        return dest;
+    }
+    
+    // Alinear el destino a 4 bytes: las escrituras cruzadas son las más caras
+    size_t head = (4 - ((uint32_t)dest & 3)) & 3;
+    if (head > n) {
+        head = n;
     }
+    copy_forward(dest, src, head);
+    copy_forward((uint8_t*)dest + head, (const uint8_t*)src + head, n - head);
     return dest;
 }
 
@@ -13,31 +140,55 @@ void* memmove(void* dest, const void* src, size_t n) {
     uint8_t* d = (uint8_t*)dest;
     const uint8_t* s = (const uint8_t*)src;
     
-    if (d < s) {
-        while (n--) {
-            *d++ = *s++;
-        }
-    } else {
-        d += n;
-        s += n;
-        while (n--) {
-            *--d = *--s;
-        }
+    // Sin solapamiento peligroso vale la copia hacia delante
+    if (d <= s || d >= s + n) {
+        return memcpy(dest, src, n);
     }
+    
+    // Destino por encima del origen: hacia atrás con DF=1, primero los bytes sueltos
+    // del final y después palabras desde el último dword completo
+    uint32_t d0, d1, d2;
+    asm volatile("std\n\t"
+                 "rep movsb\n\t"
+                 "subl $3, %%esi\n\t"
+                 "subl $3, %%edi\n\t"
+                 "movl %4, %%ecx\n\t"
+                 "rep movsl\n\t"
+                 "cld"
+                 : "=&c"(d0), "=&D"(d1), "=&S"(d2)
+                 : "0"(n & 3), "g"(n >> 2), "1"(d + n - 1), "2"(s + n - 1)
+                 : "memory");
     return dest;
 }
 
 void* memset(void* s, int c, size_t n) {
-    uint8_t* p = (uint8_t*)s;
-    while (n--) {
-        *p++ = (uint8_t)c;
+    uint32_t pattern = (uint8_t)c * ONES;
+    
+    if (use_sse2 && n >= STRING_SSE2_MIN) {
+        fill_sse2((uint8_t*)s, pattern, n);
+        return s;
+    }
+    
+    size_t head = (4 - ((uint32_t)s & 3)) & 3;
+    if (head > n) {
+        head = n;
     }
+    fill(s, pattern, head);
+    fill((uint8_t*)s + head, pattern, n - head);
     return s;
 }
 
 int memcmp(const void* s1, const void* s2, size_t n) {
     const uint8_t* p1 = (const uint8_t*)s1;
     const uint8_t* p2 = (const uint8_t*)s2;
+    
+    // Palabras mientras coincidan; la primera diferencia se resuelve byte a byte
+    while (n >= 4 && *(const uint32_t*)p1 == *(const uint32_t*)p2) {
+        p1 += 4;
+        p2 += 4;
+        n -= 4;
+    }
+    
     while (n--) {
         if (*p1 != *p2) {
             return *p1 - *p2;
@@ -49,6 +200,27 @@ int memcmp(const void* s1, const void* s2, size_t n) {
 }
 
 int strcmp(const char* s1, const char* s2) {
+    // Con la misma alineación se comparan palabras alineadas, que nunca cruzan
+    // de página más allá del terminador
+    if ((((uint32_t)s1 ^ (uint32_t)s2) & 3) == 0) {
+        while ((uint32_t)s1 & 3) {
+            if (*s1 != *s2 || !*s1) {
+                return *(const uint8_t*)s1 - *(const uint8_t*)s2;
+            }
+            s1++;
+            s2++;
+        }
+        
+        const uint32_t* w1 = (const uint32_t*)s1;
+        const uint32_t* w2 = (const uint32_t*)s2;
+        while (*w1 == *w2 && !HAS_ZERO(*w1)) {
+            w1++;
+            w2++;
+        }
+        s1 = (const char*)w1;
+        s2 = (const char*)w2;
+    }
+    
     while (*s1 && (*s1 == *s2)) {
         s1++;
         s2++;
@@ -93,11 +265,26 @@ char* strcat(char* dest, const char* src) {
 }
 
 size_t strlen(const char* s) {
-    size_t len = 0;
-    while (s[len]) {
-        len++;
+    const char* p = s;
+    
+    while ((uint32_t)p & 3) {
+        if (!*p) {
+            return p - s;
+        }
+        p++;
+    }
+    
+    // Una palabra alineada nunca cruza a una página sin mapear
+    const uint32_t* w = (const uint32_t*)p;
+    while (!HAS_ZERO(*w)) {
+        w++;
+    }
+    
+    p = (const char*)w;
+    while (*p) {
+        p++;
     }
-    return len;
+    return p - s;
 }
 
 int atoi(const char* str) {
@@ -0,0 +1,28 @@
+; kernel/switch.asm
+; Cambio de contexto entre hilos del kernel
+
+[BITS 32]
+
+section .text
+global _thread_switch
+
+; void thread_switch(uint32_t* old_esp, uint32_t new_esp)
+; Solo se guardan los registros que el ABI obliga a preservar; el resto
+; ya está en la pila del llamador o en el marco de la interrupción
+_thread_switch:
+    mov eax, [esp + 4]
+    mov edx, [esp + 8]
+
+    push ebp
+    push ebx
+    push esi
+    push edi
+
+    mov [eax], esp
+    mov esp, edx
+
+    pop edi
+    pop esi
+    pop ebx
+    pop ebp
+    ret
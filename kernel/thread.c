@@ -0,0 +1,528 @@
+// kernel/thread.c
+#include "thread.h"
+#include "idt.h"
+#include "cpu.h"
+#include "memory.h"
+#include "smp.h"
+#include "spinlock.h"
+#include "timer.h"
+
+// Estado de planificación de cada procesador
+typedef struct {
+    thread_t* current;
+    thread_t* idle;
+    wait_queue_t run_queue;
+    sched_stats_t stats;
+} sched_cpu_t;
+
+static thread_t threads[THREAD_MAX];
+static sched_cpu_t sched_cpus[SMP_MAX_CPUS];
+// Protege colas y estados; se mantiene tomado durante thread_switch y lo libera el hilo que reanuda
+static spinlock_t sched_lock;
+static int next_thread_id = 0;
+static int use_fxsave = 0;
+static uint8_t initial_fpu_state[512] __attribute__((aligned(16)));
+
+extern void thread_switch(uint32_t* old_esp, uint32_t new_esp);
+
+static void fpu_save(uint8_t* state) {
+    if (use_fxsave) {
+        asm volatile("fxsave (%0)" : : "r"(state) : "memory");
+    } else {
+        asm volatile("fnsave (%0)" : : "r"(state) : "memory");
+    }
+}
+
+static void fpu_restore(uint8_t* state) {
+    if (use_fxsave) {
+        asm volatile("fxrstor (%0)" : : "r"(state) : "memory");
+    } else {
+        asm volatile("frstor (%0)" : : "r"(state) : "memory");
+    }
+}
+
+static void queue_push(wait_queue_t* q, thread_t* t) {
+    t->next = 0;
+    if (q->tail) {
+        q->tail->next = t;
+    } else {
+        q->head = t;
+    }
+    q->tail = t;
+}
+
+static thread_t* queue_pop(wait_queue_t* q) {
+    thread_t* t = q->head;
+    if (t) {
+        q->head = t->next;
+        if (!q->head) {
+            q->tail = 0;
+        }
+        t->next = 0;
+    }
+    return t;
+}
+
+static void queue_remove(wait_queue_t* q, thread_t* t) {
+    thread_t* prev = 0;
+    for (thread_t* it = q->head; it; prev = it, it = it->next) {
+        if (it != t) {
+            continue;
+        }
+        if (prev) {
+            prev->next = t->next;
+        } else {
+            q->head = t->next;
+        }
+        if (q->tail == t) {
+            q->tail = prev;
+        }
+        t->next = 0;
+        return;
+    }
+}
+
+static int cpu_usable(int cpu) {
+    const cpu_local_t* c = smp_get_cpu(cpu);
+    return cpu == 0 || (c && c->online && sched_cpus[cpu].idle);
+}
+
+// Encola el hilo en su CPU fija o, si puede migrar, en la última donde corrió
+static void make_ready(thread_t* t) {
+    int cpu = t->affinity != THREAD_ANY_CPU ? t->affinity : t->cpu;
+    if (cpu < 0 || cpu >= SMP_MAX_CPUS || !cpu_usable(cpu)) {
+        cpu = 0;
+    }
+    
+    t->state = THREAD_READY;
+    queue_push(&sched_cpus[cpu].run_queue, t);
+    sched_cpus[cpu].stats.queued++;
+}
+
+// Busca un hilo migrable en la cola más larga de otro procesador
+static thread_t* find_stealable(int self, int* victim) {
+    thread_t* found = 0;
+    uint32_t longest = 0;
+    
+    for (int i = 0; i < SMP_MAX_CPUS; i++) {
+        if (i == self || sched_cpus[i].stats.queued <= longest) {
+            continue;
+        }
+        for (thread_t* t = sched_cpus[i].run_queue.head; t; t = t->next) {
+            if (t->affinity == THREAD_ANY_CPU) {
+                found = t;
+                longest = sched_cpus[i].stats.queued;
+                *victim = i;
+                break;
+            }
+        }
+    }
+    
+    return found;
+}
+
+static thread_t* steal_thread(int self) {
+    int victim = 0;
+    thread_t* t = find_stealable(self, &victim);
+    if (t) {
+        queue_remove(&sched_cpus[victim].run_queue, t);
+        sched_cpus[victim].stats.queued--;
+        sched_cpus[self].stats.steals++;
+    }
+    return t;
+}
+
+// Elige el siguiente hilo de este procesador y cambia a él.
+// Se llama con interrupciones desactivadas y sched_lock tomado
+static void schedule(void) {
+    int id = smp_cpu_id();
+    sched_cpu_t* cpu = &sched_cpus[id];
+    thread_t* prev = cpu->current;
+    
+    // Round-robin: el hilo expulsado pasa al final de la cola
+    if (prev->state == THREAD_RUNNING && prev != cpu->idle) {
+        make_ready(prev);
+    }
+    
+    // Sin trabajo local se roba de otra cola; el hilo ocioso es el último recurso
+    thread_t* next = queue_pop(&cpu->run_queue);
+    if (next) {
+        cpu->stats.queued--;
+    } else {
+        next = steal_thread(id);
+    }
+    if (!next) {
+        next = cpu->idle;
+    }
+    
+    next->state = THREAD_RUNNING;
+    next->quantum = THREAD_QUANTUM;
+    next->cpu = id;
+    
+    if (next == prev) {
+        return;
+    }
+    
+    if (prev == cpu->idle) {
+        prev->state = THREAD_READY;
+    }
+    
+    cpu->current = next;
+    cpu->stats.switches++;
+    fpu_save(prev->fpu_state);
+    fpu_restore(next->fpu_state);
+    thread_switch(&prev->esp, next->esp);
+}
+
+static void thread_start(void) {
+    // Los hilos nuevos arrancan desde schedule() con el cerrojo tomado
+    spin_unlock(&sched_lock);
+    interrupts_enable();
+    
+    thread_t* self = thread_current();
+    self->entry(self->arg);
+    thread_exit();
+}
+
+static void idle_loop(void* arg) {
+    (void)arg;
+    for (;;) {
+        asm volatile("hlt");
+    }
+}
+
+static int thread_on_cpu(thread_t* t) {
+    for (int i = 0; i < SMP_MAX_CPUS; i++) {
+        if (sched_cpus[i].current == t) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static thread_t* thread_alloc(void) {
+    for (int i = 0; i < THREAD_MAX; i++) {
+        thread_t* t = &threads[i];
+        if ((t->state == THREAD_UNUSED || t->state == THREAD_ZOMBIE) && !thread_on_cpu(t)) {
+            return t;
+        }
+    }
+    return 0;
+}
+
+// Prepara un hilo sin encolarlo; se llama con sched_lock tomado
+static thread_t* thread_spawn(const char* name, thread_entry_t entry, void* arg, int cpu) {
+    thread_t* t = thread_alloc();
+    if (!t) {
+        return 0;
+    }
+    
+    // Las pilas se reservan una vez por ranura y se reutilizan
+    if (!t->stack) {
+        t->stack = kmem_alloc_pages(THREAD_STACK_PAGES);
+        if (!t->stack) {
+            return 0;
+        }
+    }
+    
+    t->id = next_thread_id++;
+    strncpy(t->name, name, THREAD_NAME_LEN - 1);
+    t->name[THREAD_NAME_LEN - 1] = '\0';
+    t->entry = entry;
+    t->arg = arg;
+    t->io = 0;
+    t->cpu_ticks = 0;
+    t->wake_tick = 0;
+    t->preempt_count = 0;
+    t->affinity = cpu;
+    t->cpu = cpu == THREAD_ANY_CPU ? smp_cpu_id() : cpu;
+    memcpy(t->fpu_state, initial_fpu_state, sizeof(initial_fpu_state));
+    
+    // Marco inicial que consume thread_switch: edi, esi, ebx, ebp y retorno
+    uint32_t* sp = (uint32_t*)(t->stack + THREAD_STACK_PAGES * PAGE_SIZE);
+    *--sp = 0;
+    *--sp = (uint32_t)thread_start;
+    *--sp = 0;
+    *--sp = 0;
+    *--sp = 0;
+    *--sp = 0;
+    t->esp = (uint32_t)sp;
+    t->state = THREAD_READY;
+    
+    return t;
+}
+
+void thread_init(void) {
+    memset(threads, 0, sizeof(threads));
+    memset(sched_cpus, 0, sizeof(sched_cpus));
+    spin_lock_init(&sched_lock, "sched");
+    next_thread_id = 0;
+    use_fxsave = cpu_has_feature(CPUID_EDX_FXSR) && cpu_sse_enabled();
+    
+    asm volatile("fninit");
+    fpu_save(initial_fpu_state);
+    
+    // El flujo de arranque se convierte en el hilo 0 y conserva su pila
+    thread_t* boot = &threads[0];
+    boot->id = next_thread_id++;
+    boot->state = THREAD_RUNNING;
+    boot->quantum = THREAD_QUANTUM;
+    boot->affinity = 0;
+    boot->cpu = 0;
+    strcpy(boot->name, "kernel");
+    memcpy(boot->fpu_state, initial_fpu_state, sizeof(initial_fpu_state));
+    sched_cpus[0].current = boot;
+    
+    // El hilo ocioso nunca está en la cola; schedule() lo usa como último recurso
+    sched_cpus[0].idle = thread_spawn("idle", idle_loop, 0, 0);
+}
+
+// El contexto de arranque de un AP se convierte en su hilo ocioso
+void thread_init_ap(int cpu) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    
+    thread_t* t = thread_alloc();
+    if (t) {
+        t->id = next_thread_id++;
+        strcpy(t->name, "idle");
+        t->name[4] = '0' + cpu;
+        t->name[5] = '\0';
+        t->state = THREAD_RUNNING;
+        t->quantum = THREAD_QUANTUM;
+        t->cpu_ticks = 0;
+        t->preempt_count = 0;
+        t->affinity = cpu;
+        t->cpu = cpu;
+        memcpy(t->fpu_state, initial_fpu_state, sizeof(initial_fpu_state));
+        
+        sched_cpus[cpu].current = t;
+        sched_cpus[cpu].idle = t;
+    }
+    
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+}
+
+int thread_create_on(const char* name, thread_entry_t entry, void* arg, int cpu) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    
+    thread_t* t = thread_spawn(name, entry, arg, cpu);
+    if (t) {
+        make_ready(t);
+    }
+    
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+    
+    return t ? t - threads : -1;
+}
+
+int thread_create(const char* name, thread_entry_t entry, void* arg) {
+    return thread_create_on(name, entry, arg, THREAD_ANY_CPU);
+}
+
+void thread_exit(void) {
+    interrupts_disable();
+    spin_lock(&sched_lock);
+    sched_cpus[smp_cpu_id()].current->state = THREAD_ZOMBIE;
+    schedule();
+    
+    for (;;) {
+        asm volatile("hlt");
+    }
+}
+
+void thread_yield(void) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    schedule();
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+}
+
+void thread_sleep(uint32_t ms) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    thread_t* self = sched_cpus[smp_cpu_id()].current;
+    self->wake_tick = timer_get_ticks() + timer_ms_to_ticks(ms);
+    self->state = THREAD_SLEEPING;
+    schedule();
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+}
+
+thread_t* thread_current(void) {
+    uint32_t flags = irq_save();
+    thread_t* t = sched_cpus[smp_cpu_id()].current;
+    irq_restore(flags);
+    return t;
+}
+
+thread_t* thread_get(int index) {
+    if (index < 0 || index >= THREAD_MAX || threads[index].state == THREAD_UNUSED) {
+        return 0;
+    }
+    return &threads[index];
+}
+
+int thread_get_cpu_stats(int cpu, sched_stats_t* stats) {
+    if (cpu < 0 || cpu >= SMP_MAX_CPUS || !sched_cpus[cpu].idle) {
+        return -1;
+    }
+    
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    *stats = sched_cpus[cpu].stats;
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+    return 0;
+}
+
+// Llamado desde el temporizador de cada procesador con interrupciones desactivadas
+void thread_tick(void) {
+    int id = smp_cpu_id();
+    sched_cpu_t* cpu = &sched_cpus[id];
+    if (!cpu->current) {
+        return;
+    }
+    
+    spin_lock(&sched_lock);
+    
+    thread_t* self = cpu->current;
+    self->cpu_ticks++;
+    if (self == cpu->idle) {
+        cpu->stats.idle_ticks++;
+    } else {
+        cpu->stats.busy_ticks++;
+    }
+    
+    // Solo el BSP despierta a los hilos dormidos
+    if (id == 0) {
+        uint32_t now = timer_get_ticks();
+        for (int i = 0; i < THREAD_MAX; i++) {
+            if (threads[i].state == THREAD_SLEEPING && (int32_t)(now - threads[i].wake_tick) >= 0) {
+                make_ready(&threads[i]);
+            }
+        }
+    }
+    
+    if (self->quantum > 0) {
+        self->quantum--;
+    }
+    
+    // El hilo ocioso cede en cuanto hay trabajo propio o robable
+    int victim;
+    int work = cpu->run_queue.head || find_stealable(id, &victim);
+    if (self->preempt_count == 0 && (self->quantum == 0 || (self == cpu->idle && work))) {
+        schedule();
+    }
+    
+    spin_unlock(&sched_lock);
+}
+
+void preempt_disable(void) {
+    uint32_t flags = irq_save();
+    sched_cpus[smp_cpu_id()].current->preempt_count++;
+    irq_restore(flags);
+}
+
+void preempt_enable(void) {
+    uint32_t flags = irq_save();
+    thread_t* self = sched_cpus[smp_cpu_id()].current;
+    if (self->preempt_count > 0) {
+        self->preempt_count--;
+    }
+    irq_restore(flags);
+}
+
+void wait_queue_init(wait_queue_t* wq) {
+    wq->head = 0;
+    wq->tail = 0;
+}
+
+void wait_queue_sleep(wait_queue_t* wq) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    thread_t* self = sched_cpus[smp_cpu_id()].current;
+    self->state = THREAD_BLOCKED;
+    queue_push(wq, self);
+    schedule();
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+}
+
+// Como una variable de condición: el hilo ya está en la cola cuando lock queda libre,
+// así que quien cambie la condición y despierte después no se adelanta al bloqueo
+void wait_queue_sleep_unlock(wait_queue_t* wq, spinlock_t* lock) {
+    spin_lock(&sched_lock);
+    thread_t* self = sched_cpus[smp_cpu_id()].current;
+    self->state = THREAD_BLOCKED;
+    queue_push(wq, self);
+    spin_unlock(lock);
+    schedule();
+    spin_unlock(&sched_lock);
+}
+
+void wait_queue_wake_one(wait_queue_t* wq) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    thread_t* t = queue_pop(wq);
+    if (t) {
+        make_ready(t);
+    }
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+}
+
+void wait_queue_wake_all(wait_queue_t* wq) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    thread_t* t;
+    while ((t = queue_pop(wq)) != 0) {
+        make_ready(t);
+    }
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+}
+
+void mutex_init(mutex_t* m) {
+    m->locked = 0;
+    m->owner = 0;
+    wait_queue_init(&m->waiters);
+}
+
+// El hilo se duerme en la cola del mutex sin soltar sched_lock entre la comprobación y el bloqueo
+void mutex_lock(mutex_t* m) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    
+    thread_t* self = sched_cpus[smp_cpu_id()].current;
+    while (m->locked) {
+        self->state = THREAD_BLOCKED;
+        queue_push(&m->waiters, self);
+        schedule();
+        self = sched_cpus[smp_cpu_id()].current;
+    }
+    m->locked = 1;
+    m->owner = self;
+    
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+}
+
+void mutex_unlock(mutex_t* m) {
+    uint32_t flags = irq_save();
+    spin_lock(&sched_lock);
+    
+    m->locked = 0;
+    m->owner = 0;
+    thread_t* t = queue_pop(&m->waiters);
+    if (t) {
+        make_ready(t);
+    }
+    
+    spin_unlock(&sched_lock);
+    irq_restore(flags);
+}
@@ -0,0 +1,97 @@
+// kernel/thread.h
+#ifndef THREAD_H
+#define THREAD_H
+
+#include "kernel.h"
+
+#define THREAD_MAX 32
+#define THREAD_NAME_LEN 16
+#define THREAD_STACK_PAGES 8
+// Ticks que un hilo puede ejecutar antes de ser expulsado
+#define THREAD_QUANTUM 5
+
+#define THREAD_UNUSED   0
+#define THREAD_READY    1
+#define THREAD_RUNNING  2
+#define THREAD_BLOCKED  3
+#define THREAD_SLEEPING 4
+#define THREAD_ZOMBIE   5
+
+// Afinidad: un hilo sin CPU fija puede robarse desde cualquier cola
+#define THREAD_ANY_CPU -1
+
+typedef void (*thread_entry_t)(void* arg);
+
+struct spinlock;
+
+typedef struct thread {
+    // Estado FPU/SSE para fxsave: debe ir alineado a 16 bytes
+    uint8_t fpu_state[512] __attribute__((aligned(16)));
+    uint32_t esp;
+    int id;
+    int state;
+    char name[THREAD_NAME_LEN];
+    uint8_t* stack;
+    uint32_t wake_tick;
+    uint32_t quantum;
+    uint32_t cpu_ticks;
+    uint32_t preempt_count;
+    int affinity;
+    int cpu;
+    thread_entry_t entry;
+    void* arg;
+    // Entrada y salida que el shell asocia al hilo; el planificador no la usa
+    void* io;
+    struct thread* next;
+} thread_t;
+
+typedef struct {
+    thread_t* head;
+    thread_t* tail;
+} wait_queue_t;
+
+typedef struct {
+    uint32_t queued;
+    uint32_t switches;
+    uint32_t steals;
+    uint32_t busy_ticks;
+    uint32_t idle_ticks;
+} sched_stats_t;
+
+void thread_init(void);
+void thread_init_ap(int cpu);
+int thread_create(const char* name, thread_entry_t entry, void* arg);
+int thread_create_on(const char* name, thread_entry_t entry, void* arg, int cpu);
+void thread_exit(void);
+void thread_yield(void);
+void thread_sleep(uint32_t ms);
+thread_t* thread_current(void);
+thread_t* thread_get(int index);
+int thread_get_cpu_stats(int cpu, sched_stats_t* stats);
+
+// Llamado desde la IRQ del temporizador
+void thread_tick(void);
+
+// Secciones en las que el temporizador no cambia de hilo
+void preempt_disable(void);
+void preempt_enable(void);
+
+void wait_queue_init(wait_queue_t* wq);
+void wait_queue_sleep(wait_queue_t* wq);
+// Se encola antes de soltar lock (tomado con interrupciones desactivadas): no se pierden avisos
+void wait_queue_sleep_unlock(wait_queue_t* wq, struct spinlock* lock);
+void wait_queue_wake_one(wait_queue_t* wq);
+void wait_queue_wake_all(wait_queue_t* wq);
+
+// Exclusión con espera dormida para secciones que hacen E/S; todo a cero es un mutex libre
+typedef struct {
+    volatile int locked;
+    thread_t* owner;
+    wait_queue_t waiters;
+} mutex_t;
+
+void mutex_init(mutex_t* m);
+void mutex_lock(mutex_t* m);
+void mutex_unlock(mutex_t* m);
+
+#endif
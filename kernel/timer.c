@@ -0,0 +1,46 @@
+// kernel/timer.c
+#include "timer.h"
+#include "idt.h"
+#include "thread.h"
+
+#define PIT_CHANNEL0 0x40
+#define PIT_COMMAND  0x43
+
+static volatile uint32_t timer_ticks = 0;
+
+static inline void outb(uint16_t port, uint8_t value) {
+    asm volatile("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+static void timer_handler(interrupt_frame_t* frame) {
+    (void)frame;
+    timer_ticks++;
+    thread_tick();
+}
+
+void timer_init(void) {
+    uint32_t divisor = PIT_FREQUENCY / TIMER_HZ;
+    
+    timer_ticks = 0;
+    
+    // Canal 0, acceso lo/hi, modo 2 (generador de frecuencia)
+    outb(PIT_COMMAND, 0x34);
+    outb(PIT_CHANNEL0, divisor & 0xFF);
+    outb(PIT_CHANNEL0, (divisor >> 8) & 0xFF);
+    
+    irq_register_handler(IRQ_TIMER, timer_handler);
+    irq_unmask(IRQ_TIMER);
+}
+
+uint32_t timer_get_ticks(void) {
+    return timer_ticks;
+}
+
+uint32_t timer_get_ms(void) {
+    return timer_ticks * (1000 / TIMER_HZ);
+}
+
+uint32_t timer_ms_to_ticks(uint32_t ms) {
+    uint32_t ticks = (ms * TIMER_HZ + 999) / 1000;
+    return ticks ? ticks : 1;
+}
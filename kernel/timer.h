@@ -0,0 +1,15 @@
+// kernel/timer.h
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "kernel.h"
+
+#define TIMER_HZ 100
+#define PIT_FREQUENCY 1193182
+
+void timer_init(void);
+uint32_t timer_get_ticks(void);
+uint32_t timer_get_ms(void);
+uint32_t timer_ms_to_ticks(uint32_t ms);
+
+#endif
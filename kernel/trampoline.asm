@@ -0,0 +1,67 @@
+; kernel/trampoline.asm
+; Arranque de los procesadores secundarios. smp.c copia este bloque a 0x8000
+; y el SIPI hace que cada AP empiece aquí en modo real con CS=0x0800, IP=0
+
+[BITS 16]
+
+TRAMPOLINE_BASE equ 0x8000
+
+section .text
+global _ap_trampoline_start
+global _ap_trampoline_end
+global _ap_trampoline_stack
+global _ap_trampoline_entry
+
+_ap_trampoline_start:
+    cli
+    cld
+    mov ax, cs
+    mov ds, ax
+
+    ; Direcciones relativas al inicio: el código se ejecuta en la copia, no aquí
+    lgdt [ap_gdt_descriptor - _ap_trampoline_start]
+
+    mov eax, cr0
+    or eax, 1
+    mov cr0, eax
+
+    jmp dword 0x08:(TRAMPOLINE_BASE + ap_protected_mode - _ap_trampoline_start)
+
+[BITS 32]
+ap_protected_mode:
+    mov ax, 0x10
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+
+    mov esp, [TRAMPOLINE_BASE + _ap_trampoline_stack - _ap_trampoline_start]
+    call [TRAMPOLINE_BASE + _ap_trampoline_entry - _ap_trampoline_start]
+
+.halt:
+    cli
+    hlt
+    jmp .halt
+
+; Mismos selectores que la GDT de stage2: 0x08 código, 0x10 datos
+align 8
+ap_gdt_start:
+    dq 0
+    dw 0xFFFF, 0x0000
+    db 0x00, 0x9A, 0xCF, 0x00
+    dw 0xFFFF, 0x0000
+    db 0x00, 0x92, 0xCF, 0x00
+ap_gdt_end:
+
+ap_gdt_descriptor:
+    dw ap_gdt_end - ap_gdt_start - 1
+    dd TRAMPOLINE_BASE + ap_gdt_start - _ap_trampoline_start
+
+; smp.c rellena estos campos en la copia antes de cada SIPI
+_ap_trampoline_stack:
+    dd 0
+_ap_trampoline_entry:
+    dd 0
+
+_ap_trampoline_end:
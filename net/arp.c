@@ -3,9 +3,12 @@
 #include "ethernet.h"
 #include "../drivers/network.h"
 #include "../drivers/screen.h"
+#include "../kernel/spinlock.h"
 
 static arp_cache_entry_t arp_cache[ARP_CACHE_SIZE];
 static uint32_t arp_timer = 0;
+// Las búsquedas son mucho más frecuentes que las altas
+static rwlock_t arp_lock;
 
 static uint16_t htons(uint16_t n) {
     return ((n & 0xFF) << 8) | ((n & 0xFF00) >> 8);
@@ -27,20 +30,26 @@ static uint32_t ntohl(uint32_t n) {
 }
 
 void arp_init(void) {
+    rwlock_init(&arp_lock, "arp");
+    
     for (int i = 0; i < ARP_CACHE_SIZE; i++) {
         arp_cache[i].valid = 0;
     }
     arp_timer = 0;
+    
+    eth_register_protocol(ETH_TYPE_ARP, arp_receive);
 }
 
 void arp_add_entry(uint32_t ip, const uint8_t* mac) {
     int oldest_index = 0;
     uint32_t oldest_time = 0xFFFFFFFF;
+    uint32_t flags = write_lock_irqsave(&arp_lock);
     
     for (int i = 0; i < ARP_CACHE_SIZE; i++) {
         if (arp_cache[i].valid && arp_cache[i].ip == ip) {
             memcpy(arp_cache[i].mac, mac, 6);
             arp_cache[i].timestamp = arp_timer;
+            write_unlock_irqrestore(&arp_lock, flags);
             return;
         }
         
@@ -59,16 +68,24 @@ void arp_add_entry(uint32_t ip, const uint8_t* mac) {
     memcpy(arp_cache[oldest_index].mac, mac, 6);
     arp_cache[oldest_index].timestamp = arp_timer;
     arp_cache[oldest_index].valid = 1;
+    
+    write_unlock_irqrestore(&arp_lock, flags);
 }
 
 int arp_resolve(uint32_t ip, uint8_t* mac) {
+    int found = 0;
+    uint32_t flags = read_lock_irqsave(&arp_lock);
+    
     for (int i = 0; i < ARP_CACHE_SIZE; i++) {
         if (arp_cache[i].valid && arp_cache[i].ip == ip) {
             memcpy(mac, arp_cache[i].mac, 6);
-            return 1;
+            found = 1;
+            break;
         }
     }
-    return 0;
+    
+    read_unlock_irqrestore(&arp_lock, flags);
+    return found;
 }
 
 void arp_send_request(uint32_t target_ip) {
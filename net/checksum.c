@@ -0,0 +1,132 @@
+// net/checksum.c
+#include "checksum.h"
+#include "../kernel/cpu.h"
+
+// Bloques de 16 bytes por pasada SSE2: cada carril de 32 bits suma como
+// mucho 0xFFFF por bloque, así que 65535 bloques nunca desbordan.
+#define CSUM_SSE2_MIN_LEN 64
+#define CSUM_SSE2_MAX_BLOCKS 65535
+
+typedef uint16_t csum_v8hu __attribute__((vector_size(16)));
+typedef uint32_t csum_v4su __attribute__((vector_size(16)));
+
+static int use_sse2 = 0;
+
+static uint16_t htons(uint16_t n) {
+    return ((n & 0xFF) << 8) | ((n & 0xFF00) >> 8);
+}
+
+void csum_init(void) {
+    use_sse2 = cpu_sse_enabled();
+}
+
+static uint32_t csum_reduce64(uint64_t sum) {
+    sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+    sum = (sum & 0xFFFFFFFF) + (sum >> 32);
+    return (uint32_t)sum;
+}
+
+__attribute__((target("sse2")))
+static uint64_t csum_blocks_sse2(const uint8_t* ptr, uint32_t blocks) {
+    const csum_v8hu zero = {0, 0, 0, 0, 0, 0, 0, 0};
+    csum_v4su acc_lo = {0, 0, 0, 0};
+    csum_v4su acc_hi = {0, 0, 0, 0};
+    
+    // Expande las 8 palabras de 16 bits a dos vectores de 4x32 y acumula
+    while (blocks--) {
+        csum_v8hu v;
+        __builtin_memcpy(&v, ptr, 16);
+        acc_lo += (csum_v4su)__builtin_shuffle(v, zero, (csum_v8hu){0, 8, 1, 9, 2, 10, 3, 11});
+        acc_hi += (csum_v4su)__builtin_shuffle(v, zero, (csum_v8hu){4, 12, 5, 13, 6, 14, 7, 15});
+        ptr += 16;
+    }
+    
+    uint64_t sum = 0;
+    for (int i = 0; i < 4; i++) {
+        sum += acc_lo[i];
+        sum += acc_hi[i];
+    }
+    
+    return sum;
+}
+
+uint32_t csum_partial(const void* data, uint32_t length, uint32_t sum) {
+    const uint8_t* ptr = (const uint8_t*)data;
+    uint64_t acc = sum;
+    
+    if (use_sse2 && length >= CSUM_SSE2_MIN_LEN) {
+        while (length >= 16) {
+            uint32_t blocks = length / 16;
+            if (blocks > CSUM_SSE2_MAX_BLOCKS) {
+                blocks = CSUM_SSE2_MAX_BLOCKS;
+            }
+            acc += csum_blocks_sse2(ptr, blocks);
+            ptr += blocks * 16;
+            length -= blocks * 16;
+        }
+    }
+    
+    // Palabras de 32 bits con acumulador de 64: los acarreos se pliegan al final
+    const uint32_t* words = (const uint32_t*)ptr;
+    while (length >= 16) {
+        acc += words[0];
+        acc += words[1];
+        acc += words[2];
+        acc += words[3];
+        words += 4;
+        length -= 16;
+    }
+    
+    while (length >= 4) {
+        acc += *words++;
+        length -= 4;
+    }
+    
+    ptr = (const uint8_t*)words;
+    if (length >= 2) {
+        acc += *(const uint16_t*)ptr;
+        ptr += 2;
+        length -= 2;
+    }
+    
+    if (length > 0) {
+        acc += *ptr;
+    }
+    
+    return csum_reduce64(acc);
+}
+
+uint16_t csum_fold(uint32_t sum) {
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    sum = (sum & 0xFFFF) + (sum >> 16);
+    return (uint16_t)~sum;
+}
+
+uint32_t csum_pseudo_header(uint32_t src_ip, uint32_t dest_ip, uint8_t protocol, uint16_t length) {
+    // src_ip y dest_ip en orden de host; se suman como palabras de red
+    uint64_t sum = 0;
+    sum += htons(src_ip >> 16);
+    sum += htons(src_ip & 0xFFFF);
+    sum += htons(dest_ip >> 16);
+    sum += htons(dest_ip & 0xFFFF);
+    sum += htons(protocol);
+    sum += htons(length);
+    return csum_reduce64(sum);
+}
+
+// RFC 1624, ecuación 3: HC' = ~(~HC + ~m + m')
+uint16_t csum_update16(uint16_t check, uint16_t old_value, uint16_t new_value) {
+    uint32_t sum = (uint16_t)~check;
+    sum += (uint16_t)~old_value;
+    sum += new_value;
+    return csum_fold(sum);
+}
+
+uint16_t csum_update32(uint16_t check, uint32_t old_value, uint32_t new_value) {
+    uint32_t sum = (uint16_t)~check;
+    sum += (uint16_t)~(old_value >> 16);
+    sum += (uint16_t)~(old_value & 0xFFFF);
+    sum += new_value >> 16;
+    sum += new_value & 0xFFFF;
+    return csum_fold(sum);
+}
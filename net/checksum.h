@@ -0,0 +1,17 @@
+// net/checksum.h
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include "../kernel/kernel.h"
+
+// Todas las sumas trabajan sobre los datos tal como están en memoria
+// (orden de red): el resultado de csum_fold se guarda sin htons.
+
+void csum_init(void);
+uint32_t csum_partial(const void* data, uint32_t length, uint32_t sum);
+uint16_t csum_fold(uint32_t sum);
+uint32_t csum_pseudo_header(uint32_t src_ip, uint32_t dest_ip, uint8_t protocol, uint16_t length);
+uint16_t csum_update16(uint16_t check, uint16_t old_value, uint16_t new_value);
+uint16_t csum_update32(uint16_t check, uint32_t old_value, uint32_t new_value);
+
+#endif
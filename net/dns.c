@@ -3,6 +3,8 @@
 #include "udp.h"
 #include "ethernet.h"
 #include "../drivers/network.h"
+#include "../kernel/thread.h"
+#include "../kernel/timer.h"
 
 #define DNS_TIMEOUT_MS 5000
 #define DNS_BUFFER_SIZE 512
@@ -100,7 +102,8 @@ static void dns_response_handler(uint32_t src_ip, uint16_t src_port, const uint8
 }
 
 void dns_init(void) {
-    udp_register_handler(DNS_PORT, dns_response_handler);
+    resolved_ip = 0;
+    resolution_complete = 0;
 }
 
 void dns_set_server(uint32_t server_ip) {
@@ -191,21 +194,34 @@ int dns_resolve(const char* hostname, uint32_t* ip_out) {
     resolved_ip = 0;
     resolution_complete = 0;
     
-    udp_send(dns_server, 12345, DNS_PORT, query, query_length);
+    int sock = udp_socket();
+    if (sock < 0) {
+        return 0;
+    }
+    
+    if (udp_sendto(sock, dns_server, DNS_PORT, query, query_length) < 0) {
+        udp_close(sock);
+        return 0;
+    }
     
-    uint32_t timeout = DNS_TIMEOUT_MS;
-    while (timeout > 0 && !resolution_complete) {
-        uint8_t rx_buffer[1518];
-        int rx_len = network_receive_packet(rx_buffer, sizeof(rx_buffer));
+    uint32_t start_time = timer_get_ms();
+    while (timer_get_ms() - start_time < DNS_TIMEOUT_MS && !resolution_complete) {
+        eth_poll();
         
-        if (rx_len > 0) {
-            eth_receive_frame(rx_buffer, rx_len);
+        uint8_t response[DNS_BUFFER_SIZE];
+        uint32_t src_ip;
+        uint16_t src_port;
+        int len = udp_recvfrom(sock, response, sizeof(response), &src_ip, &src_port);
+        if (len > 0 && src_ip == dns_server) {
+            dns_response_handler(src_ip, src_port, response, len);
+            continue;
         }
         
-        for (volatile int i = 0; i < 10000; i++);
-        timeout--;
+        thread_sleep(0);
     }
     
+    udp_close(sock);
+    
     if (resolution_complete && resolved_ip != 0) {
         *ip_out = resolved_ip;
         return 1;
@@ -1,11 +1,14 @@
 // net/ethernet.c
 #include "ethernet.h"
-#include "arp.h"
-#include "ip.h"
 #include "../drivers/network.h"
 
 static uint8_t local_mac[ETH_ALEN];
 
+// Tabla hash de EtherTypes con sondeo lineal. type == 0 marca una entrada
+// libre; type != 0 sin handler es una entrada borrada que no corta la búsqueda.
+static eth_protocol_t eth_protocols[ETH_PROTO_TABLE_SIZE];
+static uint32_t eth_unhandled_frames = 0;
+
 static uint16_t htons(uint16_t n) {
     return ((n & 0xFF) << 8) | ((n & 0xFF00) >> 8);
 }
@@ -14,8 +17,82 @@ static uint16_t ntohs(uint16_t n) {
     return htons(n);
 }
 
+static int eth_hash(uint16_t eth_type) {
+    return (eth_type ^ (eth_type >> 8)) & (ETH_PROTO_TABLE_SIZE - 1);
+}
+
+static eth_protocol_t* eth_lookup(uint16_t eth_type) {
+    int slot = eth_hash(eth_type);
+    
+    for (int i = 0; i < ETH_PROTO_TABLE_SIZE; i++) {
+        eth_protocol_t* proto = &eth_protocols[slot];
+        
+        if (proto->type == 0) {
+            return 0;
+        }
+        
+        if (proto->type == eth_type && proto->handler) {
+            return proto;
+        }
+        
+        slot = (slot + 1) & (ETH_PROTO_TABLE_SIZE - 1);
+    }
+    
+    return 0;
+}
+
 void eth_init(void) {
     network_get_mac(local_mac);
+    
+    memset(eth_protocols, 0, sizeof(eth_protocols));
+    eth_unhandled_frames = 0;
+}
+
+int eth_register_protocol(uint16_t eth_type, eth_handler_t handler) {
+    if (eth_type == 0 || !handler) {
+        return -1;
+    }
+    
+    eth_protocol_t* existing = eth_lookup(eth_type);
+    if (existing) {
+        existing->handler = handler;
+        return 0;
+    }
+    
+    int slot = eth_hash(eth_type);
+    
+    for (int i = 0; i < ETH_PROTO_TABLE_SIZE; i++) {
+        eth_protocol_t* proto = &eth_protocols[slot];
+        
+        if (proto->type == 0 || !proto->handler) {
+            memset(proto, 0, sizeof(eth_protocol_t));
+            proto->type = eth_type;
+            proto->handler = handler;
+            return 0;
+        }
+        
+        slot = (slot + 1) & (ETH_PROTO_TABLE_SIZE - 1);
+    }
+    
+    return -1;
+}
+
+void eth_unregister_protocol(uint16_t eth_type) {
+    eth_protocol_t* proto = eth_lookup(eth_type);
+    if (proto) {
+        proto->handler = 0;
+    }
+}
+
+const eth_protocol_t* eth_get_protocol(int slot) {
+    if (slot < 0 || slot >= ETH_PROTO_TABLE_SIZE || !eth_protocols[slot].handler) {
+        return 0;
+    }
+    return &eth_protocols[slot];
+}
+
+uint32_t eth_get_unhandled_frames(void) {
+    return eth_unhandled_frames;
 }
 
 void eth_send_frame(const uint8_t* dest_mac, uint16_t eth_type, const uint8_t* data, uint16_t length) {
@@ -39,6 +116,12 @@ void eth_send_frame(const uint8_t* dest_mac, uint16_t eth_type, const uint8_t* d
     }
     
     network_send_packet(frame, frame_length);
+    
+    eth_protocol_t* proto = eth_lookup(eth_type);
+    if (proto) {
+        proto->tx_packets++;
+        proto->tx_bytes += length;
+    }
 }
 
 void eth_receive_frame(const uint8_t* frame, uint16_t length) {
@@ -52,20 +135,35 @@ void eth_receive_frame(const uint8_t* frame, uint16_t length) {
     const uint8_t* payload = frame + ETH_HLEN;
     uint16_t payload_length = length - ETH_HLEN;
     
-    switch (eth_type) {
-        case ETH_TYPE_ARP:
-            arp_receive(payload, payload_length);
-            break;
-            
-        case ETH_TYPE_IP:
-            ip_receive(payload, payload_length);
-            break;
-            
-        default:
-            break;
+    eth_protocol_t* proto = eth_lookup(eth_type);
+    if (!proto) {
+        eth_unhandled_frames++;
+        return;
     }
+    
+    proto->rx_packets++;
+    proto->rx_bytes += payload_length;
+    proto->handler(payload, payload_length);
 }
 
 void eth_get_mac(uint8_t* mac) {
     memcpy(mac, local_mac, ETH_ALEN);
+}
+
+// Procesa las tramas pendientes de la NIC; el hilo de recepción y los que esperan respuesta la comparten.
+// Cada trama sale de la NIC bajo el cerrojo del dispositivo y los protocolos protegen su propio estado
+int eth_poll(void) {
+    uint8_t rx_buffer[ETH_FRAME_LEN];
+    int frames = 0;
+    
+    while (frames < ETH_POLL_BUDGET) {
+        int rx_len = network_receive_packet(rx_buffer, sizeof(rx_buffer));
+        if (rx_len <= 0) {
+            break;
+        }
+        eth_receive_frame(rx_buffer, rx_len);
+        frames++;
+    }
+
+    return frames;
 }
\ No newline at end of file
@@ -12,6 +12,21 @@
 #define ETH_TYPE_ARP  0x0806
 #define ETH_TYPE_IP   0x0800
 
+#define ETH_PROTO_TABLE_SIZE 16
+// Tramas procesadas como máximo por llamada a eth_poll
+#define ETH_POLL_BUDGET 16
+
+typedef void (*eth_handler_t)(const uint8_t* data, uint16_t length);
+
+typedef struct {
+    uint16_t type;
+    eth_handler_t handler;
+    uint32_t rx_packets;
+    uint32_t rx_bytes;
+    uint32_t tx_packets;
+    uint32_t tx_bytes;
+} eth_protocol_t;
+
 typedef struct {
     uint8_t dest[ETH_ALEN];
     uint8_t src[ETH_ALEN];
@@ -21,6 +36,12 @@ typedef struct {
 void eth_init(void);
 void eth_send_frame(const uint8_t* dest_mac, uint16_t eth_type, const uint8_t* data, uint16_t length);
 void eth_receive_frame(const uint8_t* frame, uint16_t length);
+int eth_poll(void);
 void eth_get_mac(uint8_t* mac);
 
+int eth_register_protocol(uint16_t eth_type, eth_handler_t handler);
+void eth_unregister_protocol(uint16_t eth_type);
+const eth_protocol_t* eth_get_protocol(int slot);
+uint32_t eth_get_unhandled_frames(void);
+
 #endif
\ No newline at end of file
@@ -2,13 +2,25 @@
 #include "icmp.h"
 #include "ip.h"
 #include "ethernet.h"
+#include "checksum.h"
 #include "../drivers/network.h"
 #include "../drivers/screen.h"
+#include "../kernel/thread.h"
+#include "../kernel/timer.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/memory.h"
 
 #define MAX_PING_STATES 16
 
+// icmp_receive puede anidarse (ip_send -> eth_poll -> ip_receive), así que cada paquete
+// en construcción ocupa su propio buffer en lugar de 8 KB de la pila del hilo
+#define ICMP_BUFFERS 4
+
 static icmp_ping_state_t ping_states[MAX_PING_STATES];
-static uint32_t icmp_timer = 0;
+static spinlock_t ping_lock;
+
+static uint8_t* icmp_buffers[ICMP_BUFFERS];
+static uint8_t icmp_buffer_busy[ICMP_BUFFERS];
 
 static uint16_t htons(uint16_t n) {
     return ((n & 0xFF) << 8) | ((n & 0xFF00) >> 8);
@@ -19,14 +31,58 @@ static uint16_t ntohs(uint16_t n) {
 }
 
 void icmp_init(void) {
+    spin_lock_init(&ping_lock, "icmp");
+    
     for (int i = 0; i < MAX_PING_STATES; i++) {
         ping_states[i].received = 0;
     }
-    icmp_timer = 0;
+    
+    for (int i = 0; i < ICMP_BUFFERS; i++) {
+        if (!icmp_buffers[i]) {
+            icmp_buffers[i] = kmem_alloc(IP_MAX_PAYLOAD);
+        }
+        icmp_buffer_busy[i] = 0;
+    }
+    
+    ip_register_protocol(IP_PROTO_ICMP, icmp_receive);
 }
 
-void icmp_send_echo_request(uint32_t dest_ip, uint16_t id, uint16_t sequence) {
-    uint8_t packet[64];
+// Sin buffer libre el paquete se descarta, como haría una cola de transmisión llena
+static uint8_t* icmp_buffer_get(void) {
+    uint8_t* buffer = 0;
+    uint32_t flags = spin_lock_irqsave(&ping_lock);
+    for (int i = 0; i < ICMP_BUFFERS; i++) {
+        if (icmp_buffers[i] && !icmp_buffer_busy[i]) {
+            icmp_buffer_busy[i] = 1;
+            buffer = icmp_buffers[i];
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&ping_lock, flags);
+    return buffer;
+}
+
+static void icmp_buffer_put(uint8_t* buffer) {
+    uint32_t flags = spin_lock_irqsave(&ping_lock);
+    for (int i = 0; i < ICMP_BUFFERS; i++) {
+        if (icmp_buffers[i] == buffer) {
+            icmp_buffer_busy[i] = 0;
+            break;
+        }
+    }
+    spin_unlock_irqrestore(&ping_lock, flags);
+}
+
+void icmp_send_echo_request(uint32_t dest_ip, uint16_t id, uint16_t sequence, uint16_t payload_size) {
+    uint8_t* packet = icmp_buffer_get();
+    if (!packet) {
+        return;
+    }
+    
+    if (payload_size > IP_MAX_PAYLOAD - sizeof(icmp_header_t)) {
+        payload_size = IP_MAX_PAYLOAD - sizeof(icmp_header_t);
+    }
+    
     icmp_header_t* header = (icmp_header_t*)packet;
     
     header->type = ICMP_TYPE_ECHO_REQUEST;
@@ -35,17 +91,18 @@ void icmp_send_echo_request(uint32_t dest_ip, uint16_t id, uint16_t sequence) {
     header->id = htons(id);
     header->sequence = htons(sequence);
     
-    for (int i = 0; i < 56; i++) {
+    for (int i = 0; i < payload_size; i++) {
         packet[sizeof(icmp_header_t) + i] = 0x41 + (i % 26);
     }
     
-    uint16_t packet_size = sizeof(icmp_header_t) + 56;
-    header->checksum = htons(ip_checksum(packet, packet_size));
+    uint16_t packet_size = sizeof(icmp_header_t) + payload_size;
+    header->checksum = ip_checksum(packet, packet_size);
     
     int slot = -1;
+    uint32_t flags = spin_lock_irqsave(&ping_lock);
     for (int i = 0; i < MAX_PING_STATES; i++) {
         if (!ping_states[i].received || 
-            (icmp_timer - ping_states[i].timestamp) > 5000) {
+            (timer_get_ms() - ping_states[i].timestamp) > 5000) {
             slot = i;
             break;
         }
@@ -54,11 +111,13 @@ void icmp_send_echo_request(uint32_t dest_ip, uint16_t id, uint16_t sequence) {
     if (slot >= 0) {
         ping_states[slot].ip = dest_ip;
         ping_states[slot].sequence = sequence;
-        ping_states[slot].timestamp = icmp_timer;
+        ping_states[slot].timestamp = timer_get_ms();
         ping_states[slot].received = 0;
     }
+    spin_unlock_irqrestore(&ping_lock, flags);
     
     ip_send(dest_ip, IP_PROTO_ICMP, packet, packet_size);
+    icmp_buffer_put(packet);
 }
 
 void icmp_receive(uint32_t src_ip, const uint8_t* data, uint16_t length) {
@@ -69,19 +128,25 @@ void icmp_receive(uint32_t src_ip, const uint8_t* data, uint16_t length) {
     icmp_header_t* header = (icmp_header_t*)data;
     
     if (header->type == ICMP_TYPE_ECHO_REQUEST) {
-        uint8_t reply[1500];
+        uint8_t* reply = icmp_buffer_get();
+        if (!reply) {
+            return;
+        }
         memcpy(reply, data, length);
         
+        // Solo cambia la palabra tipo/código: actualizar el checksum (RFC 1624)
         icmp_header_t* reply_header = (icmp_header_t*)reply;
+        uint16_t old_word = *(uint16_t*)reply;
         reply_header->type = ICMP_TYPE_ECHO_REPLY;
         reply_header->code = ICMP_CODE_ECHO;
-        reply_header->checksum = 0;
-        reply_header->checksum = htons(ip_checksum(reply, length));
+        reply_header->checksum = csum_update16(reply_header->checksum, old_word, *(uint16_t*)reply);
         
         ip_send(src_ip, IP_PROTO_ICMP, reply, length);
+        icmp_buffer_put(reply);
     }
     else if (header->type == ICMP_TYPE_ECHO_REPLY) {
         uint16_t sequence = ntohs(header->sequence);
+        uint32_t flags = spin_lock_irqsave(&ping_lock);
         
         for (int i = 0; i < MAX_PING_STATES; i++) {
             if (ping_states[i].ip == src_ip && 
@@ -91,30 +156,35 @@ void icmp_receive(uint32_t src_ip, const uint8_t* data, uint16_t length) {
                 break;
             }
         }
+        
+        spin_unlock_irqrestore(&ping_lock, flags);
     }
 }
 
 int icmp_wait_reply(uint32_t dest_ip, uint16_t sequence, uint32_t timeout_ms) {
-    uint32_t start_time = icmp_timer;
+    uint32_t start_time = timer_get_ms();
     
-    while ((icmp_timer - start_time) < timeout_ms) {
-        uint8_t rx_buffer[1518];
-        int rx_len = network_receive_packet(rx_buffer, sizeof(rx_buffer));
-        
-        if (rx_len > 0) {
-            eth_receive_frame(rx_buffer, rx_len);
-        }
+    while ((timer_get_ms() - start_time) < timeout_ms) {
+        eth_poll();
         
+        int found = 0;
+        uint32_t flags = spin_lock_irqsave(&ping_lock);
         for (int i = 0; i < MAX_PING_STATES; i++) {
             if (ping_states[i].ip == dest_ip && 
                 ping_states[i].sequence == sequence &&
                 ping_states[i].received) {
-                return 1;
+                found = 1;
+                break;
             }
         }
+        spin_unlock_irqrestore(&ping_lock, flags);
+        
+        if (found) {
+            return 1;
+        }
         
-        icmp_timer++;
-        for (volatile int i = 0; i < 10000; i++);
+        // Ceder la CPU hasta el siguiente tick en lugar de esperar activamente
+        thread_sleep(0);
     }
     
     return 0;
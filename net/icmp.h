@@ -9,6 +9,8 @@
 
 #define ICMP_CODE_ECHO 0
 
+#define ICMP_ECHO_DEFAULT_PAYLOAD 56
+
 typedef struct {
     uint8_t type;
     uint8_t code;
@@ -26,7 +28,7 @@ typedef struct {
 
 void icmp_init(void);
 void icmp_receive(uint32_t src_ip, const uint8_t* data, uint16_t length);
-void icmp_send_echo_request(uint32_t dest_ip, uint16_t id, uint16_t sequence);
+void icmp_send_echo_request(uint32_t dest_ip, uint16_t id, uint16_t sequence, uint16_t payload_size);
 int icmp_wait_reply(uint32_t dest_ip, uint16_t sequence, uint32_t timeout_ms);
 
 #endif
\ No newline at end of file
@@ -1,12 +1,19 @@
 // net/ip.c
 #include "ip.h"
-#include "icmp.h"
-#include "udp.h"
 #include "arp.h"
 #include "ethernet.h"
+#include "checksum.h"
 #include "../drivers/network.h"
+#include "../drivers/rtc.h"
+#include "../kernel/thread.h"
+#include "../kernel/atomic.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/memory.h"
 
-static uint16_t ip_id_counter = 0;
+static atomic_t ip_id_counter;
+static ip_protocol_t ip_protocols[256];
+static ip_reasm_entry_t* reasm_table = 0;
+static spinlock_t reasm_lock;
 
 static uint16_t htons(uint16_t n) {
     return ((n & 0xFF) << 8) | ((n & 0xFF00) >> 8);
@@ -28,89 +35,264 @@ static uint32_t ntohl(uint32_t n) {
 }
 
 void ip_init(void) {
-    ip_id_counter = 1;
-}
-
-uint16_t ip_checksum(const uint8_t* data, uint16_t length) {
-    uint32_t sum = 0;
-    const uint16_t* ptr = (const uint16_t*)data;
+    atomic_set(&ip_id_counter, 1);
+    spin_lock_init(&reasm_lock, "ip_reasm");
     
-    while (length > 1) {
-        sum += *ptr++;
-        length -= 2;
+    // Sin memoria para reensamblar los fragmentos se descartan
+    if (!reasm_table) {
+        reasm_table = kmem_alloc(IP_REASM_SLOTS * sizeof(ip_reasm_entry_t));
     }
     
-    if (length > 0) {
-        sum += *(uint8_t*)ptr;
+    for (int i = 0; reasm_table && i < IP_REASM_SLOTS; i++) {
+        reasm_table[i].in_use = 0;
     }
     
-    while (sum >> 16) {
-        sum = (sum & 0xFFFF) + (sum >> 16);
+    memset(ip_protocols, 0, sizeof(ip_protocols));
+    eth_register_protocol(ETH_TYPE_IP, ip_receive);
+}
+
+int ip_register_protocol(uint8_t protocol, ip_handler_t handler) {
+    if (!handler) {
+        return -1;
     }
     
-    return ~sum;
+    memset(&ip_protocols[protocol], 0, sizeof(ip_protocol_t));
+    ip_protocols[protocol].handler = handler;
+    return 0;
 }
 
-void ip_send(uint32_t dest_ip, uint8_t protocol, const uint8_t* data, uint16_t length) {
-    uint8_t packet[1500];
-    ip_header_t* header = (ip_header_t*)packet;
+void ip_unregister_protocol(uint8_t protocol) {
+    ip_protocols[protocol].handler = 0;
+}
+
+const ip_protocol_t* ip_get_protocol(uint8_t protocol) {
+    if (!ip_protocols[protocol].handler) {
+        return 0;
+    }
+    return &ip_protocols[protocol];
+}
+
+uint16_t ip_checksum(const uint8_t* data, uint16_t length) {
+    return csum_fold(csum_partial(data, length, 0));
+}
+
+static int ip_resolve_next_hop(uint32_t dest_ip, uint8_t* dest_mac) {
+    uint32_t local_ip = network_get_ip();
+    uint32_t gateway = (local_ip & 0xFFFFFF00) | 0x01;
+    uint32_t subnet_mask = 0xFFFFFF00;
     
-    uint16_t total_length = IP_HEADER_MIN_LEN + length;
-    if (total_length > 1500) {
-        return;
+    uint32_t target_ip;
+    if ((dest_ip & subnet_mask) == (local_ip & subnet_mask)) {
+        target_ip = dest_ip;
+    } else {
+        target_ip = gateway;
     }
     
+    if (arp_resolve(target_ip, dest_mac)) {
+        return 1;
+    }
+    
+    arp_send_request(target_ip);
+    
+    for (int retry = 0; retry < 10; retry++) {
+        thread_sleep(IP_ARP_RETRY_MS);
+        eth_poll();
+        
+        if (arp_resolve(target_ip, dest_mac)) {
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+static void ip_build_header(ip_header_t* header, uint32_t dest_ip, uint8_t protocol,
+                            uint16_t id, uint16_t flags_fragment, uint16_t total_length) {
     header->version_ihl = 0x45;
     header->tos = 0;
     header->total_length = htons(total_length);
-    header->identification = htons(ip_id_counter++);
-    header->flags_fragment = htons(0x4000);
+    header->identification = htons(id);
+    header->flags_fragment = htons(flags_fragment);
     header->ttl = IP_DEFAULT_TTL;
     header->protocol = protocol;
     header->checksum = 0;
     header->src_ip = htonl(network_get_ip());
     header->dest_ip = htonl(dest_ip);
     
-    header->checksum = htons(ip_checksum((uint8_t*)header, IP_HEADER_MIN_LEN));
-    
-    memcpy(packet + IP_HEADER_MIN_LEN, data, length);
+    header->checksum = ip_checksum((uint8_t*)header, IP_HEADER_MIN_LEN);
+}
+
+void ip_send(uint32_t dest_ip, uint8_t protocol, const uint8_t* data, uint16_t length) {
+    if (length > 0xFFFF - IP_HEADER_MIN_LEN) {
+        return;
+    }
     
     uint8_t dest_mac[6];
+    if (!ip_resolve_next_hop(dest_ip, dest_mac)) {
+        return;
+    }
     
-    uint32_t local_ip = network_get_ip();
-    uint32_t gateway = (local_ip & 0xFFFFFF00) | 0x01;
-    uint32_t subnet_mask = 0xFFFFFF00;
+    uint8_t packet[IP_MTU];
+    ip_header_t* header = (ip_header_t*)packet;
+    uint16_t id = atomic_fetch_add(&ip_id_counter, 1);
     
-    uint32_t target_ip;
-    if ((dest_ip & subnet_mask) == (local_ip & subnet_mask)) {
-        target_ip = dest_ip;
-    } else {
-        target_ip = gateway;
+    ip_protocols[protocol].tx_packets++;
+    ip_protocols[protocol].tx_bytes += length;
+
+    // Cabe en un solo paquete: se envía con DF como antes
+    if (IP_HEADER_MIN_LEN + length <= IP_MTU) {
+        uint16_t total_length = IP_HEADER_MIN_LEN + length;
+        ip_build_header(header, dest_ip, protocol, id, IP_FLAG_DF, total_length);
+        memcpy(packet + IP_HEADER_MIN_LEN, data, length);
+        eth_send_frame(dest_mac, ETH_TYPE_IP, packet, total_length);
+        network_flush();
+        return;
     }
     
-    if (!arp_resolve(target_ip, dest_mac)) {
-        arp_send_request(target_ip);
+    // Fragmentar: cada fragmento salvo el último lleva un múltiplo de 8 bytes
+    uint16_t max_fragment = (IP_MTU - IP_HEADER_MIN_LEN) & ~7;
+    uint16_t offset = 0;
+    
+    while (offset < length) {
+        uint16_t fragment_length = length - offset;
+        uint16_t flags = 0;
         
-        for (int retry = 0; retry < 10; retry++) {
-            for (volatile int i = 0; i < 1000000; i++);
-            
-            uint8_t rx_buffer[1518];
-            int rx_len = network_receive_packet(rx_buffer, sizeof(rx_buffer));
-            if (rx_len > 0) {
-                eth_receive_frame(rx_buffer, rx_len);
-            }
-            
-            if (arp_resolve(target_ip, dest_mac)) {
-                break;
-            }
+        if (fragment_length > max_fragment) {
+            fragment_length = max_fragment;
+            flags = IP_FLAG_MF;
         }
         
-        if (!arp_resolve(target_ip, dest_mac)) {
-            return;
+        uint16_t total_length = IP_HEADER_MIN_LEN + fragment_length;
+        ip_build_header(header, dest_ip, protocol, id, flags | (offset >> 3), total_length);
+        memcpy(packet + IP_HEADER_MIN_LEN, data + offset, fragment_length);
+        eth_send_frame(dest_mac, ETH_TYPE_IP, packet, total_length);
+        
+        offset += fragment_length;
+    }
+    
+    // Todos los fragmentos salen con un único aviso a la NIC
+    network_flush();
+}
+
+static void ip_deliver(uint32_t src_ip, uint8_t protocol, const uint8_t* payload, uint16_t payload_length) {
+    ip_protocol_t* proto = &ip_protocols[protocol];
+    if (!proto->handler) {
+        return;
+    }
+    
+    proto->rx_packets++;
+    proto->rx_bytes += payload_length;
+    proto->handler(src_ip, payload, payload_length);
+}
+
+static ip_reasm_entry_t* ip_reasm_lookup(uint32_t src_ip, uint16_t id, uint8_t protocol, uint32_t now) {
+    ip_reasm_entry_t* free_entry = 0;
+    ip_reasm_entry_t* oldest = 0;
+    
+    for (int i = 0; i < IP_REASM_SLOTS; i++) {
+        ip_reasm_entry_t* entry = &reasm_table[i];
+        
+        // Descartar datagramas incompletos que superaron el timeout
+        if (entry->in_use == 1 && now - entry->timestamp > IP_REASM_TIMEOUT) {
+            entry->in_use = 0;
+        }
+        
+        if (entry->in_use == 0) {
+            if (!free_entry) free_entry = entry;
+            continue;
+        }
+        
+        if (entry->src_ip == src_ip && entry->id == id && entry->protocol == protocol) {
+            return entry;
         }
+        
+        if (entry->in_use == 1 && (!oldest || entry->timestamp < oldest->timestamp)) {
+            oldest = entry;
+        }
+    }
+    
+    ip_reasm_entry_t* entry = free_entry ? free_entry : oldest;
+    if (!entry) {
+        return 0;
+    }
+    
+    entry->in_use = 1;
+    entry->src_ip = src_ip;
+    entry->id = id;
+    entry->protocol = protocol;
+    entry->total_length = 0;
+    entry->timestamp = now;
+    memset(entry->block_map, 0, sizeof(entry->block_map));
+    
+    return entry;
+}
+
+static int ip_reasm_complete(const ip_reasm_entry_t* entry) {
+    if (entry->total_length == 0) {
+        return 0;
+    }
+    
+    uint16_t blocks = (entry->total_length + 7) / 8;
+    for (uint16_t b = 0; b < blocks; b++) {
+        if (!(entry->block_map[b / 8] & (1 << (b % 8)))) {
+            return 0;
+        }
+    }
+    
+    return 1;
+}
+
+static void ip_reassemble(uint32_t src_ip, const ip_header_t* header,
+                          const uint8_t* payload, uint16_t payload_length) {
+    uint16_t flags_fragment = ntohs(header->flags_fragment);
+    uint32_t offset = (uint32_t)(flags_fragment & IP_FRAG_OFFSET_MASK) * 8;
+    int more_fragments = (flags_fragment & IP_FLAG_MF) != 0;
+    
+    if (!reasm_table || offset + payload_length > IP_MAX_PAYLOAD) {
+        return;
+    }
+    
+    // Todos los fragmentos salvo el último deben ser múltiplos de 8 bytes
+    if (more_fragments && (payload_length & 7)) {
+        return;
     }
     
-    eth_send_frame(dest_mac, ETH_TYPE_IP, packet, total_length);
+    uint32_t now = rtc_get_unix_timestamp();
+    uint32_t flags = spin_lock_irqsave(&reasm_lock);
+    
+    ip_reasm_entry_t* entry = ip_reasm_lookup(src_ip, ntohs(header->identification),
+                                              header->protocol, now);
+    if (!entry || entry->in_use != 1) {
+        spin_unlock_irqrestore(&reasm_lock, flags);
+        return;
+    }
+    
+    memcpy(entry->data + offset, payload, payload_length);
+    
+    uint16_t first_block = offset / 8;
+    uint16_t last_block = (offset + payload_length + 7) / 8;
+    for (uint16_t b = first_block; b < last_block; b++) {
+        entry->block_map[b / 8] |= (1 << (b % 8));
+    }
+    
+    if (!more_fragments) {
+        entry->total_length = offset + payload_length;
+    }
+    
+    if (!ip_reasm_complete(entry)) {
+        spin_unlock_irqrestore(&reasm_lock, flags);
+        return;
+    }
+    
+    // Mientras se entrega el datagrama la entrada no puede reutilizarse; la entrega va sin cerrojo
+    entry->in_use = 2;
+    spin_unlock_irqrestore(&reasm_lock, flags);
+    
+    ip_deliver(entry->src_ip, entry->protocol, entry->data, entry->total_length);
+    
+    flags = spin_lock_irqsave(&reasm_lock);
+    entry->in_use = 0;
+    spin_unlock_irqrestore(&reasm_lock, flags);
 }
 
 void ip_receive(const uint8_t* data, uint16_t length) {
@@ -131,7 +313,11 @@ void ip_receive(const uint8_t* data, uint16_t length) {
     }
     
     uint16_t total_length = ntohs(header->total_length);
-    if (total_length > length) {
+    if (total_length > length || total_length < ihl) {
+        return;
+    }
+    
+    if (ip_checksum(data, ihl) != 0) {
         return;
     }
     
@@ -147,16 +333,11 @@ void ip_receive(const uint8_t* data, uint16_t length) {
     
     uint32_t src_ip = ntohl(header->src_ip);
     
-    switch (header->protocol) {
-        case IP_PROTO_ICMP:
-            icmp_receive(src_ip, payload, payload_length);
-            break;
-            
-        case IP_PROTO_UDP:
-            udp_receive(src_ip, payload, payload_length);
-            break;
-            
-        default:
-            break;
+    uint16_t flags_fragment = ntohs(header->flags_fragment);
+    if ((flags_fragment & IP_FLAG_MF) || (flags_fragment & IP_FRAG_OFFSET_MASK)) {
+        ip_reassemble(src_ip, header, payload, payload_length);
+        return;
     }
+    
+    ip_deliver(src_ip, header->protocol, payload, payload_length);
 }
\ No newline at end of file
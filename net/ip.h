@@ -8,6 +8,18 @@
 #define IP_HEADER_MIN_LEN 20
 #define IP_DEFAULT_TTL 64
 
+#define IP_MTU 1500
+#define IP_MAX_PAYLOAD 8192
+
+#define IP_FLAG_DF 0x4000
+#define IP_FLAG_MF 0x2000
+#define IP_FRAG_OFFSET_MASK 0x1FFF
+
+#define IP_REASM_SLOTS 4
+#define IP_REASM_TIMEOUT 30
+// Espera entre comprobaciones de la caché ARP al resolver el siguiente salto
+#define IP_ARP_RETRY_MS 100
+
 #define IP_PROTO_ICMP 1
 #define IP_PROTO_TCP  6
 #define IP_PROTO_UDP  17
@@ -25,9 +37,35 @@ typedef struct {
     uint32_t dest_ip;
 } __attribute__((packed)) ip_header_t;
 
+typedef void (*ip_handler_t)(uint32_t src_ip, const uint8_t* data, uint16_t length);
+
+typedef struct {
+    ip_handler_t handler;
+    uint32_t rx_packets;
+    uint32_t rx_bytes;
+    uint32_t tx_packets;
+    uint32_t tx_bytes;
+} ip_protocol_t;
+
+typedef struct {
+    uint8_t in_use;
+    uint32_t src_ip;
+    uint16_t id;
+    uint8_t protocol;
+    uint16_t total_length;
+    uint32_t timestamp;
+    uint8_t block_map[IP_MAX_PAYLOAD / 64];
+    uint8_t data[IP_MAX_PAYLOAD];
+} ip_reasm_entry_t;
+
 void ip_init(void);
 void ip_receive(const uint8_t* data, uint16_t length);
 void ip_send(uint32_t dest_ip, uint8_t protocol, const uint8_t* data, uint16_t length);
+// Devuelve el checksum en orden de red, listo para guardar en la cabecera
 uint16_t ip_checksum(const uint8_t* data, uint16_t length);
 
+int ip_register_protocol(uint8_t protocol, ip_handler_t handler);
+void ip_unregister_protocol(uint8_t protocol);
+const ip_protocol_t* ip_get_protocol(uint8_t protocol);
+
 #endif
\ No newline at end of file
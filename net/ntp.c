@@ -4,6 +4,8 @@
 #include "ethernet.h"
 #include "../drivers/network.h"
 #include "../drivers/rtc.h"
+#include "../kernel/thread.h"
+#include "../kernel/timer.h"
 
 #define NTP_TIMEOUT_MS 5000
 
@@ -46,7 +48,8 @@ static void ntp_response_handler(uint32_t src_ip, uint16_t src_port, const uint8
 }
 
 void ntp_init(void) {
-    udp_register_handler(NTP_PORT, ntp_response_handler);
+    synced_timestamp = 0;
+    sync_complete = 0;
 }
 
 void ntp_set_server(uint32_t server_ip) {
@@ -66,21 +69,34 @@ int ntp_sync_time(uint32_t* timestamp_out) {
     synced_timestamp = 0;
     sync_complete = 0;
     
-    udp_send(ntp_server, NTP_PORT, NTP_PORT, (uint8_t*)&packet, sizeof(ntp_packet_t));
+    int sock = udp_socket();
+    if (sock < 0) {
+        return 0;
+    }
+    
+    if (udp_sendto(sock, ntp_server, NTP_PORT, (uint8_t*)&packet, sizeof(ntp_packet_t)) < 0) {
+        udp_close(sock);
+        return 0;
+    }
     
-    uint32_t timeout = NTP_TIMEOUT_MS;
-    while (timeout > 0 && !sync_complete) {
-        uint8_t rx_buffer[1518];
-        int rx_len = network_receive_packet(rx_buffer, sizeof(rx_buffer));
+    uint32_t start_time = timer_get_ms();
+    while (timer_get_ms() - start_time < NTP_TIMEOUT_MS && !sync_complete) {
+        eth_poll();
         
-        if (rx_len > 0) {
-            eth_receive_frame(rx_buffer, rx_len);
+        ntp_packet_t response;
+        uint32_t src_ip;
+        uint16_t src_port;
+        int len = udp_recvfrom(sock, (uint8_t*)&response, sizeof(response), &src_ip, &src_port);
+        if (len > 0 && src_ip == ntp_server) {
+            ntp_response_handler(src_ip, src_port, (uint8_t*)&response, len);
+            continue;
         }
         
-        for (volatile int i = 0; i < 10000; i++);
-        timeout--;
+        thread_sleep(0);
     }
     
+    udp_close(sock);
+    
     if (sync_complete && synced_timestamp != 0) {
         *timestamp_out = synced_timestamp;
         return 1;
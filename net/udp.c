@@ -1,16 +1,16 @@
 // net/udp.c
 #include "udp.h"
 #include "ip.h"
+#include "checksum.h"
 #include "../drivers/network.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/memory.h"
 
-#define MAX_UDP_HANDLERS 8
-
-typedef struct {
-    uint16_t port;
-    udp_callback_t callback;
-} udp_handler_t;
-
-static udp_handler_t udp_handlers[MAX_UDP_HANDLERS];
+static udp_socket_t* udp_sockets = 0;
+static int udp_hash[UDP_HASH_SIZE];
+static uint16_t next_ephemeral = UDP_EPHEMERAL_FIRST;
+// Tabla de sockets, hash de puertos y anillos de recepción
+static spinlock_t udp_lock;
 
 static uint16_t htons(uint16_t n) {
     return ((n & 0xFF) << 8) | ((n & 0xFF00) >> 8);
@@ -20,40 +20,195 @@ static uint16_t ntohs(uint16_t n) {
     return htons(n);
 }
 
-static uint32_t htonl(uint32_t n) {
-    return ((n & 0xFF) << 24) | 
-           ((n & 0xFF00) << 8) | 
-           ((n & 0xFF0000) >> 8) | 
-           ((n & 0xFF000000) >> 24);
+void udp_init(void) {
+    spin_lock_init(&udp_lock, "udp");
+    
+    // Las colas de recepción de los sockets ocupan demasiado para la imagen del kernel
+    if (!udp_sockets) {
+        udp_sockets = kmem_alloc(UDP_MAX_SOCKETS * sizeof(udp_socket_t));
+    }
+    
+    for (int i = 0; udp_sockets && i < UDP_MAX_SOCKETS; i++) {
+        udp_sockets[i].in_use = 0;
+        udp_sockets[i].local_port = 0;
+        udp_sockets[i].hash_next = -1;
+    }
+    
+    for (int i = 0; i < UDP_HASH_SIZE; i++) {
+        udp_hash[i] = -1;
+    }
+    
+    next_ephemeral = UDP_EPHEMERAL_FIRST;
+    
+    ip_register_protocol(IP_PROTO_UDP, udp_receive);
 }
 
-static uint32_t ntohl(uint32_t n) {
-    return htonl(n);
+static int udp_valid_socket(int sock) {
+    return udp_sockets && sock >= 0 && sock < UDP_MAX_SOCKETS && udp_sockets[sock].in_use;
 }
 
-void udp_init(void) {
-    for (int i = 0; i < MAX_UDP_HANDLERS; i++) {
-        udp_handlers[i].port = 0;
-        udp_handlers[i].callback = 0;
+static int udp_lookup(uint16_t port) {
+    int sock = udp_hash[port & (UDP_HASH_SIZE - 1)];
+    
+    while (sock >= 0) {
+        if (udp_sockets[sock].local_port == port) {
+            return sock;
+        }
+        sock = udp_sockets[sock].hash_next;
     }
+    
+    return -1;
+}
+
+static void udp_hash_insert(int sock) {
+    int bucket = udp_sockets[sock].local_port & (UDP_HASH_SIZE - 1);
+    udp_sockets[sock].hash_next = udp_hash[bucket];
+    udp_hash[bucket] = sock;
 }
 
-void udp_register_handler(uint16_t port, udp_callback_t callback) {
-    for (int i = 0; i < MAX_UDP_HANDLERS; i++) {
-        if (udp_handlers[i].port == 0) {
-            udp_handlers[i].port = port;
-            udp_handlers[i].callback = callback;
-            return;
+static void udp_hash_remove(int sock) {
+    int bucket = udp_sockets[sock].local_port & (UDP_HASH_SIZE - 1);
+    int* link = &udp_hash[bucket];
+    
+    while (*link >= 0) {
+        if (*link == sock) {
+            *link = udp_sockets[sock].hash_next;
+            break;
         }
+        link = &udp_sockets[*link].hash_next;
+    }
+    
+    udp_sockets[sock].hash_next = -1;
+}
+
+static uint16_t udp_alloc_ephemeral(void) {
+    uint32_t range = UDP_EPHEMERAL_LAST - UDP_EPHEMERAL_FIRST + 1;
+    
+    for (uint32_t i = 0; i < range; i++) {
+        uint16_t port = next_ephemeral;
+        
+        if (next_ephemeral == UDP_EPHEMERAL_LAST) {
+            next_ephemeral = UDP_EPHEMERAL_FIRST;
+        } else {
+            next_ephemeral++;
+        }
+        
+        if (udp_lookup(port) < 0) {
+            return port;
+        }
+    }
+    
+    return 0;
+}
+
+int udp_socket(void) {
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    
+    for (int i = 0; udp_sockets && i < UDP_MAX_SOCKETS; i++) {
+        if (!udp_sockets[i].in_use) {
+            udp_sockets[i].in_use = 1;
+            udp_sockets[i].local_port = 0;
+            udp_sockets[i].hash_next = -1;
+            udp_sockets[i].callback = 0;
+            udp_sockets[i].rx_head = 0;
+            udp_sockets[i].rx_tail = 0;
+            udp_sockets[i].rx_queued = 0;
+            udp_sockets[i].rx_dropped = 0;
+            spin_unlock_irqrestore(&udp_lock, flags);
+            return i;
+        }
+    }
+    
+    spin_unlock_irqrestore(&udp_lock, flags);
+    return -1;
+}
+
+static int udp_bind_locked(int sock, uint16_t port) {
+    if (!udp_valid_socket(sock) || udp_sockets[sock].local_port != 0) {
+        return -1;
+    }
+    
+    if (port == 0) {
+        port = udp_alloc_ephemeral();
+        if (port == 0) {
+            return -1;
+        }
+    } else if (udp_lookup(port) >= 0) {
+        return -1;
+    }
+    
+    udp_sockets[sock].local_port = port;
+    udp_hash_insert(sock);
+    return 0;
+}
+
+int udp_bind(int sock, uint16_t port) {
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    int result = udp_bind_locked(sock, port);
+    spin_unlock_irqrestore(&udp_lock, flags);
+    return result;
+}
+
+uint16_t udp_local_port(int sock) {
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    uint16_t port = udp_valid_socket(sock) ? udp_sockets[sock].local_port : 0;
+    spin_unlock_irqrestore(&udp_lock, flags);
+    return port;
+}
+
+static void udp_close_locked(int sock) {
+    if (!udp_valid_socket(sock)) {
+        return;
+    }
+    
+    if (udp_sockets[sock].local_port != 0) {
+        udp_hash_remove(sock);
+    }
+    
+    udp_sockets[sock].in_use = 0;
+    udp_sockets[sock].local_port = 0;
+    udp_sockets[sock].callback = 0;
+}
+
+void udp_close(int sock) {
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    udp_close_locked(sock);
+    spin_unlock_irqrestore(&udp_lock, flags);
+}
+
+int udp_register_handler(uint16_t port, udp_callback_t callback) {
+    int sock = udp_socket();
+    if (sock < 0) {
+        return -1;
+    }
+    
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    if (udp_bind_locked(sock, port) != 0) {
+        udp_close_locked(sock);
+        spin_unlock_irqrestore(&udp_lock, flags);
+        return -1;
+    }
+    
+    udp_sockets[sock].callback = callback;
+    spin_unlock_irqrestore(&udp_lock, flags);
+    return sock;
+}
+
+void udp_unregister_handler(uint16_t port) {
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    int sock = udp_lookup(port);
+    if (sock >= 0 && udp_sockets[sock].callback) {
+        udp_close_locked(sock);
     }
+    spin_unlock_irqrestore(&udp_lock, flags);
 }
 
 void udp_send(uint32_t dest_ip, uint16_t src_port, uint16_t dest_port, const uint8_t* data, uint16_t length) {
-    uint8_t packet[1500];
+    uint8_t packet[IP_MAX_PAYLOAD];
     udp_header_t* header = (udp_header_t*)packet;
     
     uint16_t total_length = UDP_HEADER_LEN + length;
-    if (total_length > 1500) {
+    if (length > IP_MAX_PAYLOAD - UDP_HEADER_LEN) {
         return;
     }
     
@@ -64,9 +219,115 @@ void udp_send(uint32_t dest_ip, uint16_t src_port, uint16_t dest_port, const uin
     
     memcpy(packet + UDP_HEADER_LEN, data, length);
     
+    uint32_t sum = csum_pseudo_header(network_get_ip(), dest_ip, IP_PROTO_UDP, total_length);
+    uint16_t checksum = csum_fold(csum_partial(packet, total_length, sum));
+    header->checksum = checksum ? checksum : 0xFFFF;
+    
     ip_send(dest_ip, IP_PROTO_UDP, packet, total_length);
 }
 
+int udp_sendto(int sock, uint32_t dest_ip, uint16_t dest_port, const uint8_t* data, uint16_t length) {
+    if (length > IP_MAX_PAYLOAD - UDP_HEADER_LEN) {
+        return -1;
+    }
+    
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    if (!udp_valid_socket(sock)) {
+        spin_unlock_irqrestore(&udp_lock, flags);
+        return -1;
+    }
+    
+    // Un socket sin enlazar recibe un puerto efímero en el primer envío
+    if (udp_sockets[sock].local_port == 0 && udp_bind_locked(sock, 0) != 0) {
+        spin_unlock_irqrestore(&udp_lock, flags);
+        return -1;
+    }
+    
+    uint16_t src_port = udp_sockets[sock].local_port;
+    spin_unlock_irqrestore(&udp_lock, flags);
+    
+    // El envío puede esperar a ARP, así que va fuera del cerrojo
+    udp_send(dest_ip, src_port, dest_port, data, length);
+    return length;
+}
+
+static void udp_ring_write(udp_socket_t* s, const void* data, uint32_t length) {
+    uint32_t pos = s->rx_head % UDP_SOCKET_RX_BUFFER;
+    uint32_t first = UDP_SOCKET_RX_BUFFER - pos;
+    if (first > length) first = length;
+    
+    memcpy(s->rx_buffer + pos, data, first);
+    memcpy(s->rx_buffer, (const uint8_t*)data + first, length - first);
+    s->rx_head += length;
+}
+
+static void udp_ring_read(udp_socket_t* s, void* data, uint32_t length) {
+    uint32_t pos = s->rx_tail % UDP_SOCKET_RX_BUFFER;
+    uint32_t first = UDP_SOCKET_RX_BUFFER - pos;
+    if (first > length) first = length;
+    
+    if (data) {
+        memcpy(data, s->rx_buffer + pos, first);
+        memcpy((uint8_t*)data + first, s->rx_buffer, length - first);
+    }
+    s->rx_tail += length;
+}
+
+static void udp_enqueue(udp_socket_t* s, uint32_t src_ip, uint16_t src_port,
+                        const uint8_t* data, uint16_t length) {
+    uint32_t needed = sizeof(udp_rx_record_t) + length;
+    uint32_t used = s->rx_head - s->rx_tail;
+    
+    if (needed > UDP_SOCKET_RX_BUFFER - used) {
+        s->rx_dropped++;
+        return;
+    }
+    
+    udp_rx_record_t record;
+    record.src_ip = src_ip;
+    record.src_port = src_port;
+    record.length = length;
+    
+    udp_ring_write(s, &record, sizeof(record));
+    udp_ring_write(s, data, length);
+    s->rx_queued++;
+}
+
+int udp_recvfrom(int sock, uint8_t* buffer, uint16_t max_length, uint32_t* src_ip, uint16_t* src_port) {
+    // El hilo de recepción encola en este mismo anillo, quizá desde otro procesador
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    
+    if (!udp_valid_socket(sock) || udp_sockets[sock].rx_queued == 0) {
+        spin_unlock_irqrestore(&udp_lock, flags);
+        return -1;
+    }
+    
+    udp_socket_t* s = &udp_sockets[sock];
+    
+    udp_rx_record_t record;
+    udp_ring_read(s, &record, sizeof(record));
+    
+    // Si el buffer del llamador es pequeño el resto del datagrama se descarta
+    uint16_t copy = record.length > max_length ? max_length : record.length;
+    udp_ring_read(s, buffer, copy);
+    udp_ring_read(s, 0, record.length - copy);
+    s->rx_queued--;
+    
+    spin_unlock_irqrestore(&udp_lock, flags);
+    
+    if (src_ip) *src_ip = record.src_ip;
+    if (src_port) *src_port = record.src_port;
+    
+    return copy;
+}
+
+int udp_pending(int sock) {
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    int pending = udp_valid_socket(sock) ? (int)udp_sockets[sock].rx_queued : 0;
+    spin_unlock_irqrestore(&udp_lock, flags);
+    return pending;
+}
+
 void udp_receive(uint32_t src_ip, const uint8_t* data, uint16_t length) {
     if (length < UDP_HEADER_LEN) {
         return;
@@ -85,10 +346,24 @@ void udp_receive(uint32_t src_ip, const uint8_t* data, uint16_t length) {
     const uint8_t* payload = data + UDP_HEADER_LEN;
     uint16_t payload_length = udp_length - UDP_HEADER_LEN;
     
-    for (int i = 0; i < MAX_UDP_HANDLERS; i++) {
-        if (udp_handlers[i].port == dest_port && udp_handlers[i].callback) {
-            udp_handlers[i].callback(src_ip, src_port, payload, payload_length);
-            return;
-        }
+    uint32_t flags = spin_lock_irqsave(&udp_lock);
+    
+    int sock = udp_lookup(dest_port);
+    if (sock < 0) {
+        spin_unlock_irqrestore(&udp_lock, flags);
+        return;
     }
-}
\ No newline at end of file
+    
+    // Los callbacks pueden enviar respuestas, así que se llaman sin el cerrojo
+    udp_socket_t* s = &udp_sockets[sock];
+    udp_callback_t callback = s->callback;
+    if (!callback) {
+        udp_enqueue(s, src_ip, src_port, payload, payload_length);
+    }
+    
+    spin_unlock_irqrestore(&udp_lock, flags);
+    
+    if (callback) {
+        callback(src_ip, src_port, payload, payload_length);
+    }
+}
@@ -3,9 +3,18 @@
 #define UDP_H
 
 #include "../kernel/kernel.h"
+#include "ip.h"
 
 #define UDP_HEADER_LEN 8
 
+#define UDP_MAX_SOCKETS 8
+#define UDP_HASH_SIZE 16
+// Cabe al menos un datagrama reensamblado de tamaño máximo con su cabecera
+#define UDP_SOCKET_RX_BUFFER (2 * IP_MAX_PAYLOAD)
+
+#define UDP_EPHEMERAL_FIRST 49152
+#define UDP_EPHEMERAL_LAST  65535
+
 typedef struct {
     uint16_t src_port;
     uint16_t dest_port;
@@ -15,9 +24,39 @@ typedef struct {
 
 typedef void (*udp_callback_t)(uint32_t src_ip, uint16_t src_port, const uint8_t* data, uint16_t length);
 
+// Cabecera de cada datagrama guardado en la cola de un socket
+typedef struct {
+    uint32_t src_ip;
+    uint16_t src_port;
+    uint16_t length;
+} udp_rx_record_t;
+
+typedef struct {
+    uint8_t in_use;
+    uint16_t local_port;
+    int hash_next;
+    udp_callback_t callback;
+    uint32_t rx_head;
+    uint32_t rx_tail;
+    uint32_t rx_queued;
+    uint32_t rx_dropped;
+    uint8_t rx_buffer[UDP_SOCKET_RX_BUFFER];
+} udp_socket_t;
+
 void udp_init(void);
 void udp_receive(uint32_t src_ip, const uint8_t* data, uint16_t length);
 void udp_send(uint32_t dest_ip, uint16_t src_port, uint16_t dest_port, const uint8_t* data, uint16_t length);
-void udp_register_handler(uint16_t port, udp_callback_t callback);
 
-#endif
\ No newline at end of file
+// API de sockets: descriptores >= 0, -1 en caso de error
+int udp_socket(void);
+int udp_bind(int sock, uint16_t port);
+int udp_sendto(int sock, uint32_t dest_ip, uint16_t dest_port, const uint8_t* data, uint16_t length);
+int udp_recvfrom(int sock, uint8_t* buffer, uint16_t max_length, uint32_t* src_ip, uint16_t* src_port);
+int udp_pending(int sock);
+uint16_t udp_local_port(int sock);
+void udp_close(int sock);
+
+int udp_register_handler(uint16_t port, udp_callback_t callback);
+void udp_unregister_handler(uint16_t port);
+
+#endif
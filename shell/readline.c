@@ -0,0 +1,314 @@
+// shell/readline.c
+#include "readline.h"
+#include "../drivers/screen.h"
+#include "../drivers/keyboard.h"
+
+#define CTRL(c) ((c) & 0x1F)
+
+// Historial circular: history_total cuenta todas las líneas añadidas
+static char history[READLINE_HISTORY_SIZE][READLINE_MAX_LINE];
+static int history_total = 0;
+
+static char saved_line[READLINE_MAX_LINE];
+static char scratch[READLINE_MAX_LINE * 2 + 1];
+static char candidates[2048];
+
+typedef struct {
+    char* buf;
+    int max;
+    int len;
+    int pos;
+    int start;      // posición lineal en pantalla (fila * columnas + columna) del primer carácter
+    int shown;      // caracteres que había dibujados tras el prompt
+} line_state_t;
+
+static void line_place_cursor(line_state_t* ls, int index) {
+    int cols, rows;
+    screen_get_size(&cols, &rows);
+    
+    int linear = ls->start + index;
+    if (linear < 0) linear = 0;
+    if (linear >= cols * rows) linear = cols * rows - 1;
+    
+    screen_set_cursor(linear % cols, linear / cols);
+}
+
+// Redibuja desde 'from' hasta el final con una sola escritura y borra los restos
+static void line_refresh(line_state_t* ls, int from) {
+    int cols, rows;
+    screen_get_size(&cols, &rows);
+    
+    line_place_cursor(ls, from);
+    
+    int n = 0;
+    for (int i = from; i < ls->len; i++) {
+        scratch[n++] = ls->buf[i];
+    }
+    for (int i = ls->len; i < ls->shown; i++) {
+        scratch[n++] = ' ';
+    }
+    scratch[n] = '\0';
+    screen_print(scratch);
+    
+    // Si la pantalla se desplazó, el principio de la línea subió con ella
+    int col, row;
+    screen_get_cursor(&col, &row);
+    int end = ls->len > ls->shown ? ls->len : ls->shown;
+    ls->start = row * cols + col - end;
+    ls->shown = ls->len;
+    
+    line_place_cursor(ls, ls->pos);
+}
+
+static void line_insert(line_state_t* ls, const char* text, int count) {
+    if (count > ls->max - 1 - ls->len) {
+        count = ls->max - 1 - ls->len;
+    }
+    if (count <= 0) {
+        return;
+    }
+    
+    int from = ls->pos;
+    memmove(ls->buf + ls->pos + count, ls->buf + ls->pos, ls->len - ls->pos);
+    memcpy(ls->buf + ls->pos, text, count);
+    ls->len += count;
+    ls->pos += count;
+    line_refresh(ls, from);
+}
+
+static void line_delete(line_state_t* ls, int at, int count) {
+    if (at < 0 || count <= 0 || at + count > ls->len) {
+        return;
+    }
+    
+    memmove(ls->buf + at, ls->buf + at + count, ls->len - at - count);
+    ls->len -= count;
+    ls->pos = at;
+    line_refresh(ls, at);
+}
+
+static void line_set(line_state_t* ls, const char* text) {
+    int len = strlen(text);
+    if (len > ls->max - 1) {
+        len = ls->max - 1;
+    }
+    
+    memcpy(ls->buf, text, len);
+    ls->len = len;
+    ls->pos = len;
+    line_refresh(ls, 0);
+}
+
+static void history_add(const char* line) {
+    if (!line[0]) {
+        return;
+    }
+    if (history_total > 0 &&
+        strcmp(history[(history_total - 1) & (READLINE_HISTORY_SIZE - 1)], line) == 0) {
+        return;
+    }
+    
+    char* slot = history[history_total & (READLINE_HISTORY_SIZE - 1)];
+    strncpy(slot, line, READLINE_MAX_LINE - 1);
+    slot[READLINE_MAX_LINE - 1] = '\0';
+    history_total++;
+}
+
+
+static void line_complete(line_state_t* ls, const readline_ops_t* ops) {
+    if (!ops || !ops->complete) {
+        return;
+    }
+    
+    int word_start = ls->pos;
+    while (word_start > 0 && ls->buf[word_start - 1] != ' ') {
+        word_start--;
+    }
+    
+    int command = 1;
+    for (int i = 0; i < word_start; i++) {
+        if (ls->buf[i] != ' ') {
+            command = 0;
+            break;
+        }
+    }
+    
+    char prefix[READLINE_MAX_LINE];
+    int prefix_len = ls->pos - word_start;
+    memcpy(prefix, ls->buf + word_start, prefix_len);
+    prefix[prefix_len] = '\0';
+    
+    int count = ops->complete(command, prefix, candidates, sizeof(candidates));
+    if (count <= 0) {
+        return;
+    }
+    
+    // Prefijo común de todos los candidatos
+    int common = 0;
+    while (candidates[common] && candidates[common] != '\n') {
+        common++;
+    }
+    const char* c = candidates;
+    while (*c) {
+        int i = 0;
+        while (i < common && c[i] == candidates[i]) {
+            i++;
+        }
+        common = i;
+        while (*c && *c != '\n') c++;
+        if (*c) c++;
+    }
+    
+    if (common > prefix_len) {
+        line_insert(ls, candidates + prefix_len, common - prefix_len);
+        if (count == 1 && candidates[common - 1] != '/') {
+            line_insert(ls, " ", 1);
+        }
+        return;
+    }
+    
+    if (count == 1) {
+        return;
+    }
+    
+    // Ambiguo y sin nada que añadir: listar los candidatos y redibujar la línea
+    line_place_cursor(ls, ls->len);
+    screen_print("\n");
+    for (c = candidates; *c; c++) {
+        if (*c == '\n') {
+            screen_print("  ");
+        } else {
+            screen_print_char(*c);
+        }
+    }
+    screen_print("\n");
+    
+    if (ops->print_prompt) {
+        ops->print_prompt();
+    }
+    int cols, rows, col, row;
+    screen_get_size(&cols, &rows);
+    screen_get_cursor(&col, &row);
+    ls->start = row * cols + col;
+    ls->shown = 0;
+    line_refresh(ls, 0);
+}
+
+// Editor de línea: cursores, Inicio/Fin, Supr, historial con arriba/abajo y Tab
+int readline(char* buffer, int max_length, const readline_ops_t* ops) {
+    line_state_t ls;
+    int cols, rows, col, row;
+    
+    screen_get_size(&cols, &rows);
+    screen_get_cursor(&col, &row);
+    
+    ls.buf = buffer;
+    ls.max = max_length < READLINE_MAX_LINE ? max_length : READLINE_MAX_LINE;
+    ls.len = 0;
+    ls.pos = 0;
+    ls.start = row * cols + col;
+    ls.shown = 0;
+    
+    int browse = history_total;
+    int oldest = history_total > READLINE_HISTORY_SIZE ? history_total - READLINE_HISTORY_SIZE : 0;
+    
+    while (1) {
+        key_event_t key;
+        keyboard_read_key(&key);
+        char c = key.ascii;
+        
+        if (c == '\n') {
+            line_place_cursor(&ls, ls.len);
+            screen_print_char('\n');
+            buffer[ls.len] = '\0';
+            history_add(buffer);
+            return ls.len;
+        }
+        
+        if (c == CTRL('c')) {
+            line_place_cursor(&ls, ls.len);
+            screen_print("^C\n");
+            buffer[0] = '\0';
+            return 0;
+        }
+        
+        if (c == '\b') {
+            if (ls.pos > 0) {
+                line_delete(&ls, ls.pos - 1, 1);
+            }
+            continue;
+        }
+        
+        if (c == '\t') {
+            line_complete(&ls, ops);
+            continue;
+        }
+        
+        if (c == CTRL('a')) {
+            ls.pos = 0;
+            line_place_cursor(&ls, ls.pos);
+            continue;
+        }
+        
+        if (c == CTRL('e')) {
+            ls.pos = ls.len;
+            line_place_cursor(&ls, ls.pos);
+            continue;
+        }
+        
+        if (c == CTRL('u')) {
+            line_delete(&ls, 0, ls.pos);
+            continue;
+        }
+        
+        if (c >= 32 && c <= 126) {
+            line_insert(&ls, &c, 1);
+            continue;
+        }
+        
+        if (c) {
+            continue;
+        }
+        
+        switch (key.scancode) {
+            case KEY_LEFT:
+                if (ls.pos > 0) ls.pos--;
+                line_place_cursor(&ls, ls.pos);
+                break;
+            case KEY_RIGHT:
+                if (ls.pos < ls.len) ls.pos++;
+                line_place_cursor(&ls, ls.pos);
+                break;
+            case KEY_HOME:
+                ls.pos = 0;
+                line_place_cursor(&ls, ls.pos);
+                break;
+            case KEY_END:
+                ls.pos = ls.len;
+                line_place_cursor(&ls, ls.pos);
+                break;
+            case KEY_DELETE:
+                if (ls.pos < ls.len) {
+                    line_delete(&ls, ls.pos, 1);
+                }
+                break;
+            case KEY_UP:
+                if (browse > oldest) {
+                    if (browse == history_total) {
+                        buffer[ls.len] = '\0';
+                        strcpy(saved_line, buffer);
+                    }
+                    browse--;
+                    line_set(&ls, history[browse & (READLINE_HISTORY_SIZE - 1)]);
+                }
+                break;
+            case KEY_DOWN:
+                if (browse < history_total) {
+                    browse++;
+                    line_set(&ls, browse == history_total ? saved_line :
+                                  history[browse & (READLINE_HISTORY_SIZE - 1)]);
+                }
+                break;
+        }
+    }
+}
@@ -0,0 +1,20 @@
+// shell/readline.h
+#ifndef READLINE_H
+#define READLINE_H
+
+#include "../kernel/kernel.h"
+
+#define READLINE_MAX_LINE 256
+#define READLINE_HISTORY_SIZE 32    // potencia de dos
+
+typedef struct {
+    // Vuelve a imprimir el prompt tras listar candidatos de completado
+    void (*print_prompt)(void);
+    // Escribe en out los candidatos que empiezan por prefix separados por '\n'
+    // y devuelve cuántos hay. command indica si la palabra es la orden
+    int (*complete)(int command, const char* prefix, char* out, int out_size);
+} readline_ops_t;
+
+int readline(char* buffer, int max_length, const readline_ops_t* ops);
+
+#endif
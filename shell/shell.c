@@ -2,12 +2,18 @@
 #include "shell.h"
 #include "../drivers/screen.h"
 #include "../drivers/keyboard.h"
+#include "readline.h"
+#include "stream.h"
 #include "../fs/filesystem.h"
 #include "../bin/commands.h"
 #include "../kernel/kernel.h"
+#include "../kernel/kprintf.h"
+#include "../kernel/thread.h"
 
 #define MAX_ARGS     20
-#define MAX_ARG_LEN  64
+#define MAX_STAGES   8
+#define MAX_JOBS     4
+#define COMMAND_HASH_SIZE 64    // potencia de dos, mayor que el número de órdenes
 
 static char current_dir[256] = "/";
 static char username[64] = "";
@@ -17,6 +23,44 @@ typedef struct {
     void (*func)(int argc, char** argv);
 } command_t;
 
+// Entrada y salida de una orden; 0 es el teclado o la consola
+typedef struct {
+    stream_t* in;
+    stream_t* out;
+} shell_io_t;
+
+typedef struct shell_job shell_job_t;
+
+typedef struct {
+    const command_t* cmd;
+    int argc;
+    char* argv[MAX_ARGS + 1];
+    shell_io_t io;
+    shell_job_t* job;
+} shell_stage_t;
+
+// Una línea: órdenes unidas por '|' con redirecciones opcionales al principio y al final
+struct shell_job {
+    char words[READLINE_MAX_LINE * 2];
+    shell_stage_t stages[MAX_STAGES];
+    int count;
+    const char* input;
+    const char* output;
+    int append;
+    
+    // Etapas que aún corren en sus hilos
+    int running;
+    spinlock_t lock;
+    wait_queue_t done;
+    
+    // Trabajos en segundo plano ('&'): su salida espera en una tubería hasta fg o wait
+    int background;
+    int in_use;
+    int reported;
+    stream_t* buffer;
+    char line[READLINE_MAX_LINE];
+};
+
 extern void cmd_help(int argc, char** argv);
 extern void cmd_clear(int argc, char** argv);
 extern void cmd_ls(int argc, char** argv);
@@ -33,6 +77,18 @@ extern void cmd_date(int argc, char** argv);
 extern void cmd_shutdown(int argc, char** argv);
 extern void cmd_reboot(int argc, char** argv);
 extern void cmd_ping(int argc, char** argv);
+extern void cmd_netstat(int argc, char** argv);
+extern void cmd_smp(int argc, char** argv);
+extern void cmd_lockstat(int argc, char** argv);
+extern void cmd_mem(int argc, char** argv);
+extern void cmd_boottime(int argc, char** argv);
+extern void cmd_grep(int argc, char** argv);
+extern void cmd_head(int argc, char** argv);
+extern void cmd_membench(int argc, char** argv);
+
+static void cmd_jobs(int argc, char** argv);
+static void cmd_fg(int argc, char** argv);
+static void cmd_wait(int argc, char** argv);
 
 static const command_t commands[] = {
     {"help",     cmd_help},
@@ -51,50 +107,171 @@ static const command_t commands[] = {
     {"shutdown", cmd_shutdown},
     {"reboot",   cmd_reboot},
     {"ping",     cmd_ping},
+    {"netstat",  cmd_netstat},
+    {"smp",      cmd_smp},
+    {"lockstat", cmd_lockstat},
+    {"mem",      cmd_mem},
+    {"boottime", cmd_boottime},
+    {"grep",     cmd_grep},
+    {"head",     cmd_head},
+    {"membench", cmd_membench},
+    {"jobs",     cmd_jobs},
+    {"fg",       cmd_fg},
+    {"wait",     cmd_wait},
 };
 
 static const int num_commands = sizeof(commands) / sizeof(command_t);
 
-static char argv_buffer[MAX_ARGS][MAX_ARG_LEN];
-
-static void parse_command(const char* input, char** argv, int* argc) {
-    *argc = 0;
-    int in_quotes = 0;
-    int i = 0;
-    int buf_pos = 0;
+// Hash perfecto sobre commands[]: índice + 1 en cada ranura, 0 si está vacía
+static uint8_t command_hash[COMMAND_HASH_SIZE];
+static uint32_t command_seed = 0;
+static int command_hash_ready = 0;
 
-    while (input[i] && *argc < MAX_ARGS) {
-        char c = input[i];
+static char completion_list[2048];
+static shell_job_t foreground;
+static shell_job_t jobs[MAX_JOBS];
 
-        if (c == '"') {
-            in_quotes = !in_quotes;
-            i++;
-            continue;
-        }
+static uint32_t command_hash_of(const char* name, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    while (*name) {
+        hash ^= (uint8_t)*name++;
+        hash *= 16777619u;
+    }
+    return hash & (COMMAND_HASH_SIZE - 1);
+}
 
-        if ((c == ' ' || c == '\t') && !in_quotes) {
-            if (buf_pos > 0) {
-                argv_buffer[*argc][buf_pos] = '\0';
-                argv[*argc] = argv_buffer[*argc];
-                (*argc)++;
-                buf_pos = 0;
+// Prueba semillas hasta que ninguna orden colisione
+static void build_command_hash(void) {
+    for (uint32_t seed = 0; seed < 1024; seed++) {
+        memset(command_hash, 0, sizeof(command_hash));
+        
+        int i;
+        for (i = 0; i < num_commands; i++) {
+            uint32_t slot = command_hash_of(commands[i].name, seed);
+            if (command_hash[slot]) {
+                break;
             }
-            i++;
-            continue;
+            command_hash[slot] = i + 1;
+        }
+        
+        if (i == num_commands) {
+            command_seed = seed;
+            command_hash_ready = 1;
+            return;
         }
+    }
+    
+    // Sin semilla válida lookup_command recorre la tabla
+    command_hash_ready = 0;
+}
 
-        if (buf_pos < MAX_ARG_LEN - 1) {
-            argv_buffer[*argc][buf_pos++] = c;
+static const command_t* lookup_command(const char* name) {
+    if (command_hash_ready) {
+        uint8_t entry = command_hash[command_hash_of(name, command_seed)];
+        if (entry && strcmp(commands[entry - 1].name, name) == 0) {
+            return &commands[entry - 1];
+        }
+        return 0;
+    }
+    
+    for (int i = 0; i < num_commands; i++) {
+        if (strcmp(commands[i].name, name) == 0) {
+            return &commands[i];
         }
+    }
+    return 0;
+}
 
-        i++;
+static int append_candidate(char* out, int* used, int out_size,
+                            const char* head, int head_len, const char* tail, int tail_len) {
+    if (*used + head_len + tail_len + 2 > out_size) {
+        return 0;
     }
+    
+    memcpy(out + *used, head, head_len);
+    memcpy(out + *used + head_len, tail, tail_len);
+    *used += head_len + tail_len;
+    out[(*used)++] = '\n';
+    out[*used] = '\0';
+    return 1;
+}
 
-    if (buf_pos > 0 && *argc < MAX_ARGS) {
-        argv_buffer[*argc][buf_pos] = '\0';
-        argv[*argc] = argv_buffer[*argc];
-        (*argc)++;
+// Entradas del directorio de prefix cuyo nombre empieza por la parte final
+static int complete_path(const char* prefix, char* out, int* used, int out_size) {
+    // Separar el directorio del nombre parcial
+    const char* base = prefix;
+    for (const char* p = prefix; *p; p++) {
+        if (*p == '/') base = p + 1;
+    }
+    int dir_len = base - prefix;
+    int base_len = strlen(base);
+    
+    // Una ruta que no cabe no puede existir: sin candidatos
+    char dir[256];
+    if (prefix[0] == '/') {
+        if (dir_len >= (int)sizeof(dir)) {
+            return 0;
+        }
+        memcpy(dir, prefix, dir_len);
+        dir[dir_len] = '\0';
+    } else {
+        if (strlen(current_dir) + 1 + dir_len >= sizeof(dir)) {
+            return 0;
+        }
+        strcpy(dir, current_dir);
+        if (dir_len > 0) {
+            if (strcmp(current_dir, "/") != 0) strcat(dir, "/");
+            int end = strlen(dir);
+            memcpy(dir + end, prefix, dir_len);
+            dir[end + dir_len] = '\0';
+        }
+    }
+    
+    if (fs_list_dir(dir, completion_list, sizeof(completion_list)) < 0) {
+        return 0;
     }
+    
+    int count = 0;
+    char* line = completion_list;
+    while (*line) {
+        char* end = line;
+        while (*end && *end != '\n') end++;
+        
+        if (end - line >= base_len && strncmp(line, base, base_len) == 0 &&
+            append_candidate(out, used, out_size, prefix, dir_len, line, end - line)) {
+            count++;
+        }
+        
+        line = *end ? end + 1 : end;
+    }
+    
+    return count;
+}
+
+// Candidatos para el tabulador: órdenes en la primera palabra, rutas en el resto
+static int complete_word(int command, const char* prefix, char* out, int out_size) {
+    int used = 0;
+    int count = 0;
+    out[0] = '\0';
+    
+    if (command) {
+        int prefix_len = strlen(prefix);
+        for (int i = 0; i < num_commands; i++) {
+            if (strncmp(commands[i].name, prefix, prefix_len) == 0 &&
+                append_candidate(out, &used, out_size, "", 0,
+                                 commands[i].name, strlen(commands[i].name))) {
+                count++;
+            }
+        }
+    } else {
+        count = complete_path(prefix, out, &used, out_size);
+    }
+    
+    // La lista sin el '\n' final
+    if (used > 0) {
+        out[used - 1] = '\0';
+    }
+    return count;
 }
 
 static void get_display_path(char* output) {
@@ -148,6 +325,431 @@ static void print_prompt(void) {
     screen_print("$ ");
 }
 
+static int is_separator(char c) {
+    return c == ' ' || c == '\t' || c == '|' || c == '<' || c == '>';
+}
+
+static int syntax_error(const char* message) {
+    screen_print("shell: ");
+    screen_print(message);
+    screen_print("\n");
+    return -1;
+}
+
+// Trocea la línea en palabras dentro de job->words; las comillas agrupan y anulan operadores
+static int parse_job(const char* input, shell_job_t* job) {
+    char* out = job->words;
+    char* out_end = job->words + sizeof(job->words) - 1;
+    shell_stage_t* stage = &job->stages[0];
+    char redirect = 0;
+    int i = 0;
+    
+    job->count = 0;
+    job->input = 0;
+    job->output = 0;
+    job->append = 0;
+    stage->argc = 0;
+    
+    while (1) {
+        while (input[i] == ' ' || input[i] == '\t') {
+            i++;
+        }
+        if (!input[i]) {
+            break;
+        }
+        
+        char c = input[i];
+        if (c == '|' || c == '<' || c == '>') {
+            if (redirect) {
+                return syntax_error("syntax error: missing file name");
+            }
+            
+            if (c == '|') {
+                if (stage->argc == 0) {
+                    return syntax_error("syntax error near '|'");
+                }
+                if (job->output) {
+                    return syntax_error("output redirection must be on the last command");
+                }
+                if (job->count + 1 >= MAX_STAGES) {
+                    return syntax_error("pipeline too long");
+                }
+                stage->argv[stage->argc] = 0;
+                stage = &job->stages[++job->count];
+                stage->argc = 0;
+            } else if (c == '>' && input[i + 1] == '>') {
+                redirect = 'a';
+                i++;
+            } else {
+                redirect = c;
+            }
+            
+            i++;
+            continue;
+        }
+        
+        char* word = out;
+        int in_quotes = 0;
+        while (input[i] && (in_quotes || !is_separator(input[i]))) {
+            if (input[i] == '"') {
+                in_quotes = !in_quotes;
+            } else if (out < out_end) {
+                *out++ = input[i];
+            }
+            i++;
+        }
+        if (out >= out_end) {
+            return syntax_error("line too long");
+        }
+        *out++ = '\0';
+        
+        if (redirect == '<') {
+            if (job->count > 0) {
+                return syntax_error("input redirection must be on the first command");
+            }
+            job->input = word;
+        } else if (redirect) {
+            job->output = word;
+            job->append = redirect == 'a';
+        } else if (stage->argc < MAX_ARGS) {
+            stage->argv[stage->argc++] = word;
+        }
+        redirect = 0;
+    }
+    
+    if (redirect) {
+        return syntax_error("syntax error: missing file name");
+    }
+    
+    if (stage->argc == 0) {
+        if (job->count > 0 || job->input || job->output) {
+            return syntax_error("syntax error: missing command");
+        }
+        return 0;
+    }
+    
+    stage->argv[stage->argc] = 0;
+    job->count++;
+    return 0;
+}
+
+// Todo lo que imprime un hilo con la salida redirigida va a su flujo
+static int shell_output(const char* data, uint32_t length) {
+    thread_t* self = thread_current();
+    shell_io_t* io = self ? self->io : 0;
+    
+    if (!io || !io->out) {
+        return 0;
+    }
+    
+    // Sin lector (p. ej. 'head' ya terminó) la salida se descarta
+    stream_write(io->out, data, length);
+    return 1;
+}
+
+static void run_stage(shell_stage_t* stage) {
+    thread_t* self = thread_current();
+    self->io = &stage->io;
+    stage->cmd->func(stage->argc, stage->argv);
+    self->io = 0;
+    
+    // Cerrar los extremos avisa al vecino: EOF para el lector, tubería rota para el escritor
+    stream_close_reader(stage->io.in);
+    if (stream_close_writer(stage->io.out) != 0) {
+        screen_print(stage->argv[0]);
+        screen_print(": write error\n");
+    }
+}
+
+static void stage_thread(void* arg) {
+    shell_stage_t* stage = arg;
+    shell_job_t* job = stage->job;
+    
+    run_stage(stage);
+    
+    uint32_t flags = spin_lock_irqsave(&job->lock);
+    job->running--;
+    wait_queue_wake_all(&job->done);
+    spin_unlock_irqrestore(&job->lock, flags);
+}
+
+static void wait_job(shell_job_t* job) {
+    uint32_t flags = spin_lock_irqsave(&job->lock);
+    while (job->running > 0) {
+        wait_queue_sleep_unlock(&job->done, &job->lock);
+        spin_lock(&job->lock);
+    }
+    spin_unlock_irqrestore(&job->lock, flags);
+}
+
+static void close_job_streams(shell_job_t* job) {
+    for (int i = 0; i < job->count; i++) {
+        stream_close_reader(job->stages[i].io.in);
+        stream_close_writer(job->stages[i].io.out);
+    }
+}
+
+// Tuberías entre etapas y redirecciones; la salida a fichero se abre la última
+// para que un fallo anterior no tenga que deshacerla
+static int open_job_streams(shell_job_t* job) {
+    char path[256];
+    shell_stage_t* first = &job->stages[0];
+    shell_stage_t* last = &job->stages[job->count - 1];
+    
+    for (int i = 0; i < job->count; i++) {
+        job->stages[i].io.in = 0;
+        job->stages[i].io.out = 0;
+    }
+    
+    for (int i = 0; i + 1 < job->count; i++) {
+        stream_t* pipe = stream_pipe();
+        if (!pipe) {
+            close_job_streams(job);
+            screen_print("shell: too many open streams\n");
+            return -1;
+        }
+        job->stages[i].io.out = pipe;
+        job->stages[i + 1].io.in = pipe;
+    }
+    
+    if (job->input) {
+        shell_resolve_path(job->input, path);
+        first->io.in = stream_open_file(path, STREAM_READ);
+        if (!first->io.in) {
+            close_job_streams(job);
+            screen_print(job->input);
+            screen_print(": No such file or directory\n");
+            return -1;
+        }
+    }
+    
+    if (job->output) {
+        shell_resolve_path(job->output, path);
+        last->io.out = stream_open_file(path, job->append ? STREAM_APPEND : STREAM_WRITE);
+        if (!last->io.out) {
+            close_job_streams(job);
+            screen_print(job->output);
+            screen_print(": cannot open for writing\n");
+            return -1;
+        }
+    }
+    
+    job->buffer = 0;
+    if (job->background && !job->output) {
+        job->buffer = stream_pipe();
+        if (!job->buffer) {
+            close_job_streams(job);
+            screen_print("shell: too many open streams\n");
+            return -1;
+        }
+        last->io.out = job->buffer;
+    }
+    
+    return 0;
+}
+
+// Cada etapa salvo la última corre en su hilo; la última usa el hilo del shell.
+// En segundo plano también la última va en un hilo y no se espera
+static int run_job(shell_job_t* job) {
+    for (int i = 0; i < job->count; i++) {
+        shell_stage_t* stage = &job->stages[i];
+        stage->cmd = lookup_command(stage->argv[0]);
+        stage->job = job;
+        if (!stage->cmd) {
+            screen_print(stage->argv[0]);
+            screen_print(": command not found\n");
+            return -1;
+        }
+    }
+    
+    if (open_job_streams(job) != 0) {
+        return -1;
+    }
+    
+    job->running = 0;
+    int threads = job->background ? job->count : job->count - 1;
+    for (int i = 0; i < threads; i++) {
+        shell_stage_t* stage = &job->stages[i];
+        
+        uint32_t flags = spin_lock_irqsave(&job->lock);
+        job->running++;
+        spin_unlock_irqrestore(&job->lock, flags);
+        
+        if (thread_create(stage->cmd->name, stage_thread, stage) < 0) {
+            flags = spin_lock_irqsave(&job->lock);
+            job->running--;
+            spin_unlock_irqrestore(&job->lock, flags);
+            
+            // El vecino ve EOF o tubería rota y termina por su cuenta
+            stream_close_reader(stage->io.in);
+            stream_close_writer(stage->io.out);
+            screen_print(stage->argv[0]);
+            screen_print(": cannot create thread\n");
+        }
+    }
+    
+    if (!job->background) {
+        run_stage(&job->stages[job->count - 1]);
+        wait_job(job);
+    }
+    return 0;
+}
+
+static int job_running(shell_job_t* job) {
+    uint32_t flags = spin_lock_irqsave(&job->lock);
+    int running = job->running;
+    spin_unlock_irqrestore(&job->lock, flags);
+    return running;
+}
+
+// Vuelca la salida pendiente del trabajo hasta que todas sus etapas terminan
+static void collect_job(shell_job_t* job) {
+    if (job->buffer) {
+        char chunk[256];
+        int count;
+        while ((count = stream_read(job->buffer, chunk, sizeof(chunk) - 1)) > 0) {
+            chunk[count] = '\0';
+            screen_print(chunk);
+        }
+    }
+    
+    wait_job(job);
+    stream_close_reader(job->buffer);
+    job->buffer = 0;
+    job->in_use = 0;
+}
+
+// Antes de cada prompt: avisa de los trabajos terminados y libera los que no dejaron salida
+static void report_jobs(void) {
+    for (int i = 0; i < MAX_JOBS; i++) {
+        shell_job_t* job = &jobs[i];
+        if (!job->in_use || job->reported || job_running(job)) {
+            continue;
+        }
+        
+        job->reported = 1;
+        if (job->buffer && stream_pending(job->buffer) > 0) {
+            kprintf("[%d] Done    %s  (output kept, use fg %d)\n", i + 1, job->line, i + 1);
+        } else {
+            kprintf("[%d] Done    %s\n", i + 1, job->line);
+            collect_job(job);
+        }
+    }
+}
+
+// Un '&' al final manda la línea a segundo plano; se quita antes de trocearla
+static int strip_background(char* line) {
+    int length = strlen(line);
+    while (length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t')) {
+        length--;
+    }
+    
+    if (length == 0 || line[length - 1] != '&') {
+        return 0;
+    }
+    
+    length--;
+    while (length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t')) {
+        length--;
+    }
+    line[length] = '\0';
+    return 1;
+}
+
+static void start_background(const char* line) {
+    shell_job_t* job = 0;
+    int index;
+    for (index = 0; index < MAX_JOBS; index++) {
+        if (!jobs[index].in_use) {
+            job = &jobs[index];
+            break;
+        }
+    }
+    
+    if (!job) {
+        screen_print("shell: too many background jobs\n");
+        return;
+    }
+    
+    if (parse_job(line, job) != 0 || job->count == 0) {
+        return;
+    }
+    
+    job->background = 1;
+    job->reported = 0;
+    strcpy(job->line, line);
+    
+    if (run_job(job) != 0) {
+        return;
+    }
+    
+    job->in_use = 1;
+    kprintf("[%d] %s\n", index + 1, line);
+}
+
+// fg [n]: sin número, el trabajo pendiente de número más alto
+static shell_job_t* find_job(int argc, char** argv, const char* name) {
+    if (argc < 2) {
+        for (int i = MAX_JOBS - 1; i >= 0; i--) {
+            if (jobs[i].in_use) {
+                return &jobs[i];
+            }
+        }
+        screen_print(name);
+        screen_print(": no current job\n");
+        return 0;
+    }
+    
+    const char* arg = argv[1][0] == '%' ? argv[1] + 1 : argv[1];
+    int index = arg[0] - '1';
+    if (arg[0] && !arg[1] && index >= 0 && index < MAX_JOBS && jobs[index].in_use) {
+        return &jobs[index];
+    }
+    
+    screen_print(name);
+    screen_print(": ");
+    screen_print(argv[1]);
+    screen_print(": no such job\n");
+    return 0;
+}
+
+static void cmd_jobs(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (!jobs[i].in_use) {
+            continue;
+        }
+        kprintf("[%d] %-8s%s\n", i + 1, job_running(&jobs[i]) ? "Running" : "Done", jobs[i].line);
+    }
+}
+
+static void cmd_fg(int argc, char** argv) {
+    shell_job_t* job = find_job(argc, argv, "fg");
+    if (job) {
+        screen_print(job->line);
+        screen_print("\n");
+        collect_job(job);
+    }
+}
+
+static void cmd_wait(int argc, char** argv) {
+    if (argc >= 2) {
+        shell_job_t* job = find_job(argc, argv, "wait");
+        if (job) {
+            collect_job(job);
+        }
+        return;
+    }
+    
+    for (int i = 0; i < MAX_JOBS; i++) {
+        if (jobs[i].in_use) {
+            collect_job(&jobs[i]);
+        }
+    }
+}
+
 void shell_init(void) {
     fs_get_username(username);
     strcpy(current_dir, "/");
@@ -159,42 +761,41 @@ void shell_init(void) {
     if (fs_dir_exists(user_home)) {
         strcpy(current_dir, user_home);
     }
+    
+    build_command_hash();
+    
+    stream_init();
+    spin_lock_init(&foreground.lock, "shell_job");
+    wait_queue_init(&foreground.done);
+    for (int i = 0; i < MAX_JOBS; i++) {
+        jobs[i].in_use = 0;
+        spin_lock_init(&jobs[i].lock, "shell_job");
+        wait_queue_init(&jobs[i].done);
+    }
+    screen_set_redirect(shell_output);
 }
 
 void shell_run(void) {
-    char command_line[256];
+    char command_line[READLINE_MAX_LINE];
+    static const readline_ops_t ops = { print_prompt, complete_word };
 
     while (1) {
+        report_jobs();
         print_prompt();
 
-        keyboard_getline(command_line, sizeof(command_line));
+        readline(command_line, sizeof(command_line), &ops);
 
-        if (strlen(command_line) == 0) {
+        if (strip_background(command_line)) {
+            start_background(command_line);
             continue;
         }
 
-        char* argv[MAX_ARGS];
-        int argc = 0;
-
-        parse_command(command_line, argv, &argc);
-
-        if (argc == 0) {
+        if (parse_job(command_line, &foreground) != 0 || foreground.count == 0) {
             continue;
         }
 
-        int found = 0;
-        for (int i = 0; i < num_commands; i++) {
-            if (strcmp(commands[i].name, argv[0]) == 0) {
-                commands[i].func(argc, argv);
-                found = 1;
-                break;
-            }
-        }
-
-        if (!found) {
-            screen_print(argv[0]);
-            screen_print(": command not found\n");
-        }
+        foreground.background = 0;
+        run_job(&foreground);
     }
 }
 
@@ -208,4 +809,23 @@ void shell_set_current_dir(const char* dir) {
 
 char* shell_get_username(void) {
     return username;
-}
\ No newline at end of file
+}
+
+void shell_resolve_path(const char* name, char* path) {
+    if (name[0] == '/') {
+        strcpy(path, name);
+    } else if (strcmp(current_dir, "/") == 0) {
+        strcpy(path, "/");
+        strcat(path, name);
+    } else {
+        strcpy(path, current_dir);
+        strcat(path, "/");
+        strcat(path, name);
+    }
+}
+
+stream_t* shell_stdin(void) {
+    thread_t* self = thread_current();
+    shell_io_t* io = self ? self->io : 0;
+    return io ? io->in : 0;
+}
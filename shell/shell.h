@@ -3,11 +3,16 @@
 #define SHELL_H
 
 #include "../kernel/kernel.h"
+#include "stream.h"
 
 void shell_init(void);
 void shell_run(void);
 char* shell_get_current_dir(void);
 void shell_set_current_dir(const char* dir);
 char* shell_get_username(void);
+void shell_resolve_path(const char* name, char* path);
+
+// Entrada redirigida de la orden en curso; 0 si lee del teclado
+stream_t* shell_stdin(void);
 
 #endif
@@ -0,0 +1,251 @@
+// shell/stream.c
+#include "stream.h"
+#include "../fs/filesystem.h"
+#include "../kernel/memory.h"
+
+static stream_t streams[STREAM_MAX];
+static spinlock_t streams_lock;
+
+void stream_init(void) {
+    spin_lock_init(&streams_lock, "streams");
+    
+    for (int i = 0; i < STREAM_MAX; i++) {
+        streams[i].type = STREAM_FREE;
+        spin_lock_init(&streams[i].lock, "stream");
+        wait_queue_init(&streams[i].readers);
+        wait_queue_init(&streams[i].writers);
+    }
+}
+
+static stream_t* stream_alloc(int type) {
+    uint32_t flags = spin_lock_irqsave(&streams_lock);
+    
+    stream_t* s = 0;
+    for (int i = 0; i < STREAM_MAX; i++) {
+        if (streams[i].type == STREAM_FREE) {
+            s = &streams[i];
+            s->type = type;
+            s->reader_open = 1;
+            s->writer_open = 1;
+            s->head = 0;
+            s->tail = 0;
+            s->size = 0;
+            s->pos = 0;
+            s->path[0] = '\0';
+            break;
+        }
+    }
+    
+    spin_unlock_irqrestore(&streams_lock, flags);
+    return s;
+}
+
+// La ranura queda libre cuando se han cerrado los dos extremos
+static void stream_release(stream_t* s) {
+    uint32_t flags = spin_lock_irqsave(&streams_lock);
+    s->type = STREAM_FREE;
+    spin_unlock_irqrestore(&streams_lock, flags);
+}
+
+stream_t* stream_pipe(void) {
+    return stream_alloc(STREAM_PIPE);
+}
+
+stream_t* stream_open_file(const char* path, int mode) {
+    stream_t* s = stream_alloc(STREAM_FILE);
+    if (!s) {
+        return 0;
+    }
+    
+    if (!s->data) {
+        s->data = kmem_alloc(FS_MAX_FILE_SIZE);
+        if (!s->data) {
+            stream_release(s);
+            return 0;
+        }
+    }
+    
+    strncpy(s->path, path, sizeof(s->path) - 1);
+    s->path[sizeof(s->path) - 1] = '\0';
+    
+    if (mode == STREAM_WRITE) {
+        s->reader_open = 0;
+        return s;
+    }
+    
+    int size = fs_read_file(path, s->data, FS_MAX_FILE_SIZE);
+    if (size < 0) {
+        // Añadir a un fichero que no existe lo crea
+        if (mode == STREAM_APPEND) {
+            s->reader_open = 0;
+            return s;
+        }
+        stream_release(s);
+        return 0;
+    }
+    
+    s->size = size;
+    if (mode == STREAM_APPEND) {
+        s->reader_open = 0;
+    } else {
+        s->writer_open = 0;
+    }
+    return s;
+}
+
+static int pipe_write(stream_t* s, const char* data, int length) {
+    int written = 0;
+    uint32_t flags = spin_lock_irqsave(&s->lock);
+    
+    while (written < length) {
+        if (!s->reader_open) {
+            spin_unlock_irqrestore(&s->lock, flags);
+            return -1;
+        }
+        
+        uint32_t space = STREAM_PIPE_SIZE - (s->head - s->tail);
+        if (space == 0) {
+            wait_queue_sleep_unlock(&s->writers, &s->lock);
+            spin_lock(&s->lock);
+            continue;
+        }
+        
+        while (space > 0 && written < length) {
+            s->ring[s->head & (STREAM_PIPE_SIZE - 1)] = data[written++];
+            s->head++;
+            space--;
+        }
+        wait_queue_wake_all(&s->readers);
+    }
+    
+    spin_unlock_irqrestore(&s->lock, flags);
+    return written;
+}
+
+static int pipe_read(stream_t* s, char* data, int length) {
+    uint32_t flags = spin_lock_irqsave(&s->lock);
+    
+    while (s->head == s->tail && s->writer_open) {
+        wait_queue_sleep_unlock(&s->readers, &s->lock);
+        spin_lock(&s->lock);
+    }
+    
+    int count = 0;
+    while (count < length && s->tail != s->head) {
+        data[count++] = s->ring[s->tail & (STREAM_PIPE_SIZE - 1)];
+        s->tail++;
+    }
+    if (count > 0) {
+        wait_queue_wake_all(&s->writers);
+    }
+    
+    spin_unlock_irqrestore(&s->lock, flags);
+    return count;
+}
+
+int stream_write(stream_t* s, const char* data, int length) {
+    if (!s || !s->writer_open) {
+        return -1;
+    }
+    
+    if (s->type == STREAM_PIPE) {
+        return pipe_write(s, data, length);
+    }
+    
+    // Lo que no cabe en el fichero se descarta
+    int count = length;
+    if (count > (int)(FS_MAX_FILE_SIZE - s->size)) {
+        count = FS_MAX_FILE_SIZE - s->size;
+    }
+    memcpy(s->data + s->size, data, count);
+    s->size += count;
+    return length;
+}
+
+int stream_read(stream_t* s, char* data, int length) {
+    if (!s || !s->reader_open || length <= 0) {
+        return 0;
+    }
+    
+    if (s->type == STREAM_PIPE) {
+        return pipe_read(s, data, length);
+    }
+    
+    int count = s->size - s->pos;
+    if (count > length) {
+        count = length;
+    }
+    memcpy(data, s->data + s->pos, count);
+    s->pos += count;
+    return count;
+}
+
+// Lee hasta '\n' incluido; las líneas más largas se entregan en trozos
+int stream_read_line(stream_t* s, char* line, int max_length) {
+    int count = 0;
+    
+    while (count < max_length - 1) {
+        char c;
+        if (stream_read(s, &c, 1) <= 0) {
+            break;
+        }
+        line[count++] = c;
+        if (c == '\n') {
+            break;
+        }
+    }
+    
+    line[count] = '\0';
+    return count;
+}
+
+// Bytes que esperan en una tubería o que faltan por leer de un fichero
+int stream_pending(stream_t* s) {
+    if (!s) {
+        return 0;
+    }
+    
+    uint32_t flags = spin_lock_irqsave(&s->lock);
+    int pending = s->type == STREAM_PIPE ? (int)(s->head - s->tail) : (int)(s->size - s->pos);
+    spin_unlock_irqrestore(&s->lock, flags);
+    return pending;
+}
+
+void stream_close_reader(stream_t* s) {
+    if (!s) {
+        return;
+    }
+    
+    uint32_t flags = spin_lock_irqsave(&s->lock);
+    s->reader_open = 0;
+    int release = !s->writer_open;
+    wait_queue_wake_all(&s->writers);
+    spin_unlock_irqrestore(&s->lock, flags);
+    
+    if (release) {
+        stream_release(s);
+    }
+}
+
+// Cerrar el escritor de un fichero lo guarda; devuelve -1 si falla
+int stream_close_writer(stream_t* s) {
+    if (!s) {
+        return 0;
+    }
+    
+    int result = 0;
+    if (s->type == STREAM_FILE && s->writer_open) {
+        result = fs_create_file(s->path, s->data, s->size) == 0 ? 0 : -1;
+    }
+    
+    uint32_t flags = spin_lock_irqsave(&s->lock);
+    s->writer_open = 0;
+    int release = !s->reader_open;
+    wait_queue_wake_all(&s->readers);
+    spin_unlock_irqrestore(&s->lock, flags);
+    
+    if (release) {
+        stream_release(s);
+    }
+    return result;
+}
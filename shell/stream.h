@@ -0,0 +1,54 @@
+// shell/stream.h
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "../kernel/kernel.h"
+#include "../kernel/spinlock.h"
+#include "../kernel/thread.h"
+
+#define STREAM_MAX 16
+#define STREAM_PIPE_SIZE 1024      // potencia de dos
+
+#define STREAM_FREE 0
+#define STREAM_PIPE 1
+#define STREAM_FILE 2
+
+#define STREAM_READ   0
+#define STREAM_WRITE  1
+#define STREAM_APPEND 2
+
+// Tubería: anillo acotado entre un escritor y un lector que se bloquean.
+// Fichero: el sistema de ficheros solo lee y escribe ficheros enteros, así
+// que el contenido pasa por un búfer que se vuelca al cerrar el escritor
+typedef struct {
+    int type;
+    int reader_open;
+    int writer_open;
+    spinlock_t lock;
+    wait_queue_t readers;
+    wait_queue_t writers;
+    
+    char ring[STREAM_PIPE_SIZE];
+    uint32_t head;      // contadores libres; se indexan con & (STREAM_PIPE_SIZE - 1)
+    uint32_t tail;
+    
+    char path[256];
+    uint8_t* data;      // se reserva una vez por ranura y se reutiliza
+    uint32_t size;
+    uint32_t pos;
+} stream_t;
+
+void stream_init(void);
+stream_t* stream_pipe(void);
+stream_t* stream_open_file(const char* path, int mode);
+
+// Bloquean: write devuelve -1 si ya no hay lector, read devuelve 0 al final
+int stream_write(stream_t* s, const char* data, int length);
+int stream_read(stream_t* s, char* data, int length);
+int stream_read_line(stream_t* s, char* line, int max_length);
+int stream_pending(stream_t* s);
+
+void stream_close_reader(stream_t* s);
+int stream_close_writer(stream_t* s);
+
+#endif